@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace CurlX {
+
+// Per-thread monotonic arena for the short-lived strings and containers a
+// request builds (URL, merged headers, cookie lines, raw response headers).
+// Allocation is a pointer bump; everything is released in one shot when the
+// outermost Scope on the thread ends.
+//
+// Objects allocated from the arena must not outlive the Scope. Copy them into
+// a default-resource container instead of moving them out.
+class RequestArena {
+public:
+    static constexpr size_t INLINE_BUFFER_SIZE = 16 * 1024; // 16KB, no heap for typical requests
+
+    class Scope {
+    public:
+        Scope() noexcept;
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        std::pmr::memory_resource* resource() const noexcept;
+    };
+
+    // Arena of the calling thread (valid to allocate from only inside a Scope)
+    static std::pmr::memory_resource* current() noexcept;
+
+    // Open Scopes on the calling thread
+    static size_t depth() noexcept;
+
+    RequestArena() = delete;
+};
+
+} // namespace CurlX
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <curl/curl.h>
+#include "Error.hpp"
+#include "Request.hpp"
+#include "Response.hpp"
+#include "Session.hpp"
+#include "TimerWheel.hpp"
+
+namespace CurlX {
+
+// Many concurrent requests on one event loop thread: a libcurl multi handle
+// driven by epoll, with every timer in one TimerWheel: libcurl's own
+// (CURLMOPT_TIMERFUNCTION), each request's deadline, and callbacks
+// scheduled with after().
+//
+//   Session session;
+//   AsyncSession async(session);           // TrustedAsyncSession for a TrustedSession
+//   std::future<RESPONSE> page = async.send(REQUEST(URL("https://example.com/")));
+//   async.send(std::move(request), [](std::expected<RESPONSE, Error> result) { ... });
+//
+// Requests take their options, default headers and limits from `session`,
+// which must outlive the AsyncSession, as each transfer is added to the loop.
+// Completions run on the loop thread and must not block. A Delay memory
+// budget does not hold back new transfers here.
+// Only DefaultPolicy and TrustedPolicy are instantiated (in AsyncSession.cpp).
+template<typename Policy = DefaultPolicy>
+class BasicAsyncSession {
+public:
+    using Completion = std::move_only_function<void(std::expected<RESPONSE, Error>)>;
+    using session_type = BasicSession<Policy>;
+
+    explicit BasicAsyncSession(session_type& session);
+    ~BasicAsyncSession(); // Transfers still in flight fail with Cancelled
+
+    BasicAsyncSession(const BasicAsyncSession&) = delete;
+    BasicAsyncSession& operator=(const BasicAsyncSession&) = delete;
+
+    // Thread-safe. The future throws what Session::send would have thrown.
+    std::future<RESPONSE> send(REQUEST request);
+    void send(REQUEST request, Completion on_done);
+
+    // Run `callback` on the loop thread after `delay`, e.g. a retry backoff. Thread-safe.
+    void after(std::chrono::milliseconds delay, std::move_only_function<void()> callback);
+
+    // Requests submitted and not yet completed
+    size_t in_flight() const noexcept { return in_flight_.load(std::memory_order_relaxed); }
+
+private:
+    using Done = std::move_only_function<void(std::expected<RESPONSE, Error>&&, const std::string& detail)>;
+    struct Job;
+    struct CancelRequest;
+
+    class CurlMultiDeleter {
+    public:
+        void operator()(CURLM* multi) const noexcept;
+    };
+    class CurlHandleDeleter {
+    public:
+        void operator()(CURL* handle) const noexcept;
+    };
+    using EasyHandle = std::unique_ptr<CURL, CurlHandleDeleter>;
+
+    static int socket_callback(CURL* handle, curl_socket_t socket, int what, void* userp, void* socketp) noexcept;
+    static int timer_callback(CURLM* multi, long timeout_ms, void* userp) noexcept;
+
+    void submit(REQUEST&& request, Done done);
+    void wake() noexcept;
+    void run(std::stop_token stop);
+    void drain_commands();
+    void start(std::unique_ptr<Job> job);
+    void collect_completions();
+    void complete(Job& job, CURLcode result);
+    void fail(std::unique_ptr<Job> job, Error error, std::string detail = {});
+    void finish(Job& job, std::expected<RESPONSE, Error>&& result, const typename session_type::Transfer* transfer = nullptr);
+    void release(Job& job);
+
+    session_type& session_;
+    int epoll_fd_{-1};
+    int wake_fd_{-1};
+    std::unique_ptr<CURLM, CurlMultiDeleter> multi_handle_;
+    std::vector<EasyHandle> idle_handles_;
+    TimerWheel wheel_;
+    TimerWheel::TimerId curl_timer_;
+    bool curl_timer_due_{false};
+    size_t max_host_connections_{0}; // Last CURLMOPT_MAX_HOST_CONNECTIONS set on multi_handle_
+
+    // Owned by the loop thread
+    std::unordered_map<uint64_t, std::unique_ptr<Job>> jobs_;
+
+    // Handed to the loop thread under queue_mutex_
+    std::mutex queue_mutex_;
+    std::vector<std::unique_ptr<Job>> submitted_;
+    std::vector<std::pair<TimerWheel::Clock::time_point, std::move_only_function<void()>>> timers_;
+    std::vector<uint64_t> cancelled_;
+
+    uint64_t next_id_{1};
+    std::atomic<size_t> in_flight_{0};
+    std::jthread loop_;
+};
+
+using AsyncSession = BasicAsyncSession<DefaultPolicy>;
+using TrustedAsyncSession = BasicAsyncSession<TrustedPolicy>;
+
+extern template class BasicAsyncSession<DefaultPolicy>;
+extern template class BasicAsyncSession<TrustedPolicy>;
+
+} // namespace CurlX
@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <string_view>
+#include "Encoding.hpp"
 
 namespace CurlX {
     class BODY {
@@ -9,6 +10,14 @@ namespace CurlX {
         BODY(std::string_view body) : body_str(body) {}
         BODY(const char* body) : body_str(body) {}
 
+        // application/x-www-form-urlencoded body from key/value pairs (e.g. PARAMS)
+        template<typename Pairs>
+        static BODY form(const Pairs& fields) {
+            BODY body;
+            body.body_str = QueryBuilder::form(fields);
+            return body;
+        }
+
         BODY& operator=(std::string_view body) {
             body_str = body;
             return *this;
@@ -6,24 +6,41 @@
 #include <string_view>
 #include <optional>
 #include <initializer_list>
+#include <memory_resource>
 
 namespace CurlX {
     class COOKIES {
     public:
+        using StringType = std::pmr::string;
+        using Storage = std::pmr::unordered_map<StringType, StringType>;
+
         COOKIES() = default;
-        explicit COOKIES(std::unordered_map<std::string, std::string> cookie_map) : cookies_(std::move(cookie_map)) {}
+        explicit COOKIES(std::pmr::memory_resource* resource) : cookies_(resource) {}
+        explicit COOKIES(const std::unordered_map<std::string, std::string>& cookie_map) {
+            for (const auto& [key, value] : cookie_map) {
+                add(key, value);
+            }
+        }
         COOKIES(std::initializer_list<std::pair<std::string_view, std::string_view>> list) {
             for (const auto& [key, value] : list) {
                 add(key, value);
             }
         }
 
+        // Copies use the default resource unless one is given
+        COOKIES(const COOKIES& other) = default;
+        COOKIES(const COOKIES& other, std::pmr::memory_resource* resource) : cookies_(other.cookies_, resource) {}
+        COOKIES(COOKIES&& other) = default;
+        COOKIES& operator=(const COOKIES& other) = default;
+        COOKIES& operator=(COOKIES&& other) = default;
+
         void add(std::string_view key, std::string_view value);
         void remove(std::string_view cookie_name);
         [[nodiscard]] std::optional<std::string> get(std::string_view cookie_name) const;
-        [[nodiscard]] const std::unordered_map<std::string, std::string>& all() const noexcept;
+        [[nodiscard]] const Storage& all() const noexcept;
+        [[nodiscard]] std::pmr::memory_resource* resource() const noexcept;
 
     private:
-        std::unordered_map<std::string, std::string> cookies_;
+        Storage cookies_;
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <chrono>
+#include <ctime>
+
+namespace CurlX {
+    // Thread CPU time (CLOCK_THREAD_CPUTIME_ID) a request spent in the library,
+    // by phase. Set with Session::set_cpu_accounting; all zero otherwise.
+    // Compared with TIMINGS::total, it tells CPU-bound from waiting on the network.
+    struct CPU_TIME {
+        using Duration = std::chrono::nanoseconds;
+
+        Duration setup{0};     // Options, URL and query building, header merge, slist
+        Duration callbacks{0}; // Write and header callbacks (not REQUEST::output_file_path writes)
+        Duration post{0};      // Response construction: status, headers, cookies, body hand-off
+        Duration libcurl{0};   // Rest of the transfer on the sending thread: parsing, TLS, syscalls.
+                               // Session only; AsyncSession's loop serves many transfers at once.
+
+        Duration library() const noexcept { return setup + callbacks + post; } // CurlX's own code
+        Duration total() const noexcept { return library() + libcurl; }
+
+        CPU_TIME& operator+=(const CPU_TIME& other) noexcept {
+            setup += other.setup;
+            callbacks += other.callbacks;
+            post += other.post;
+            libcurl += other.libcurl;
+            return *this;
+        }
+
+        friend bool operator==(const CPU_TIME&, const CPU_TIME&) = default;
+    };
+
+    inline std::chrono::nanoseconds thread_cpu_time() noexcept {
+        timespec now{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+        return std::chrono::seconds(now.tv_sec) + std::chrono::nanoseconds(now.tv_nsec);
+    }
+
+    // Adds the thread CPU time spent in its scope to `*total`; free when total is null
+    class CpuScope {
+    public:
+        explicit CpuScope(std::chrono::nanoseconds* total) noexcept
+            : total_(total), start_(total ? thread_cpu_time() : std::chrono::nanoseconds(0)) {}
+        ~CpuScope() {
+            if (total_) {
+                *total_ += thread_cpu_time() - start_;
+            }
+        }
+
+        CpuScope(const CpuScope&) = delete;
+        CpuScope& operator=(const CpuScope&) = delete;
+
+    private:
+        std::chrono::nanoseconds* total_;
+        std::chrono::nanoseconds start_;
+    };
+}
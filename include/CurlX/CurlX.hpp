@@ -1,27 +1,46 @@
 #pragma once
 
+#include <CurlX/Arena.hpp>
+#include <CurlX/AsyncSession.hpp>
 #include <CurlX/Auth.hpp>
 #include <CurlX/Body.hpp>
 #include <CurlX/Client.hpp>
 #include <CurlX/Cookies.hpp>
+#include <CurlX/CpuTime.hpp>
+#include <CurlX/DebugCapture.hpp>
 #include <CurlX/Delete.hpp>
+#include <CurlX/Encoding.hpp>
+#include <CurlX/Error.hpp>
 #include <CurlX/Exceptions.hpp>
 #include <CurlX/Files.hpp>
 #include <CurlX/Get.hpp>
 #include <CurlX/Head.hpp>
 #include <CurlX/HeaderOutputStream.hpp>
 #include <CurlX/Headers.hpp>
+#include <CurlX/LatencyHistogram.hpp>
+#include <CurlX/Limits.hpp>
+#include <CurlX/MemoryBudget.hpp>
 #include <CurlX/Method.hpp>
 #include <CurlX/Options.hpp>
 #include <CurlX/Params.hpp>
+#include <CurlX/ParsedUrl.hpp>
 #include <CurlX/Patch.hpp>
+#include <CurlX/Pipeline.hpp>
 #include <CurlX/Post.hpp>
+#include <CurlX/Probes.hpp>
 #include <CurlX/Proxy.hpp>
 #include <CurlX/Put.hpp>
 #include <CurlX/Redirects.hpp>
 #include <CurlX/Request.hpp>
 #include <CurlX/Response.hpp>
+#include <CurlX/ResponseBody.hpp>
+#include <CurlX/Runtime.hpp>
 #include <CurlX/Session.hpp>
+#include <CurlX/Statistics.hpp>
 #include <CurlX/Timeout.hpp>
+#include <CurlX/Timings.hpp>
+#include <CurlX/TimerWheel.hpp>
+#include <CurlX/Traffic.hpp>
 #include <CurlX/Url.hpp>
+#include <CurlX/UrlTemplate.hpp>
 #include <CurlX/Verify.hpp>
\ No newline at end of file
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <curl/curl.h>
+
+namespace CurlX {
+
+// libcurl's verbose output for one request, kept because the request was
+// slow or failed
+struct DebugTrace {
+    struct Event {
+        curl_infotype type;           // CURLINFO_TEXT, CURLINFO_HEADER_IN or CURLINFO_HEADER_OUT
+        std::chrono::microseconds at; // Since the transfer started
+        std::string text;             // Without the trailing line break
+        bool truncated{false};
+    };
+
+    std::string method;
+    std::string url;                 // Redacted like the events
+    CURLcode result{CURLE_OK};
+    long status{0};                  // 0 when there was no response
+    std::chrono::microseconds total{0};
+    std::vector<Event> events;       // Oldest first
+    uint64_t dropped{0};             // Earlier events the ring overwrote
+
+    // curl -v style: "*" for text, ">" sent, "<" received
+    std::string to_string() const;
+};
+
+// Tail-sampled debug capture, set per Session. Every transfer records its
+// libcurl debug events (headers, connection and TLS messages, no body data)
+// into a ring buffer; the trace is only kept, handed to `sink` and attached
+// to the RESPONSE, when the request turns out slow or failed.
+struct DEBUG_CAPTURE {
+    std::chrono::microseconds slower_than{std::chrono::seconds(1)}; // Keep requests that took at least this long
+    bool keep_failures{true};  // Keep transfer errors and 5xx responses
+    size_t max_events{128};    // Ring size; older events are overwritten
+    size_t max_event_bytes{1024}; // Longer events are truncated
+    // Replace Authorization, Proxy-Authorization, Cookie and Set-Cookie values,
+    // and the userinfo and query of URLs, with "[redacted]" before storing
+    bool redact_secrets{true};
+    // Called on the thread that finished the request (AsyncSession's loop for
+    // its requests), so it should be quick. Exceptions are swallowed. It runs
+    // outside the session lock but must not call back into the session.
+    std::function<void(const DebugTrace&)> sink;
+};
+
+// A kept trace on its way to the sink. Delivered once the session lock is
+// released, so a sink that takes its own locks cannot deadlock with a send.
+struct PendingTrace {
+    std::shared_ptr<const DEBUG_CAPTURE> options;
+    std::shared_ptr<const DebugTrace> trace;
+
+    explicit operator bool() const noexcept { return trace != nullptr; }
+    // Hands the trace to the sink, if any, once
+    void deliver() noexcept;
+};
+
+// Records one transfer's debug events. Slots reuse their capacity when the
+// ring wraps, and live in the transfer's transient resource, so a request
+// that is not kept costs no heap allocation past the first lap.
+class DebugRecorder {
+public:
+    DebugRecorder(std::shared_ptr<const DEBUG_CAPTURE> options, std::pmr::memory_resource* resource);
+
+    // CURLOPT_DEBUGFUNCTION, with the recorder as CURLOPT_DEBUGDATA
+    static int callback(CURL* handle, curl_infotype type, char* data, size_t size, void* recorder) noexcept;
+    void record(curl_infotype type, std::string_view text);
+
+    bool keeps(CURLcode result, long status, std::chrono::microseconds total) const noexcept;
+    // The trace if keeps(), for PendingTrace::deliver; empty otherwise
+    PendingTrace finish(std::string_view method, std::string_view url, CURLcode result,
+                        long status, std::chrono::microseconds total) const;
+
+    size_t size() const noexcept { return slots_.size(); }
+
+private:
+    struct Slot {
+        using allocator_type = std::pmr::polymorphic_allocator<>;
+
+        Slot(curl_infotype t, std::chrono::microseconds a, const allocator_type& alloc) : type(t), at(a), text(alloc) {}
+        Slot(Slot&& other, const allocator_type& alloc)
+            : type(other.type), at(other.at), text(std::move(other.text), alloc), truncated(other.truncated) {}
+
+        curl_infotype type;
+        std::chrono::microseconds at;
+        std::pmr::string text;
+        bool truncated{false};
+    };
+
+    std::shared_ptr<const DEBUG_CAPTURE> options_;
+    std::chrono::steady_clock::time_point start_;
+    std::pmr::vector<Slot> slots_;
+    uint64_t recorded_{0};
+};
+
+} // namespace CurlX
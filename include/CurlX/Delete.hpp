@@ -28,9 +28,9 @@ namespace CurlX {
     }
 
     // Variadic template DELETE function (uses a provided session)
-    template<typename... Args>
-    CurlX::RESPONSE DELETE(Session& session, const URL& url, Args&&... args) {
-        REQUEST request(url, METHOD::DELETE); // Start with URL and DELETE method
+    template<typename Policy, typename... Args>
+    CurlX::RESPONSE DELETE(BasicSession<Policy>& session, const URL& url, Args&&... args) {
+        REQUEST request(url, VERB<METHOD::Verb::DELETE>{}); // Start with URL and DELETE method
 
         // Apply each option to the request
         (apply_option(request, std::forward<Args>(args)), ...); // C++17 fold expression
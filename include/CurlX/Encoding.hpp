@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace CurlX {
+
+enum class EncodeMode {
+    Query, // RFC 3986: only unreserved characters pass, space becomes %20
+    Form   // application/x-www-form-urlencoded: space becomes '+'
+};
+
+// Table-driven percent-encoding.
+// Runs of safe bytes are copied as a block, and the output size is known
+// before anything is written, so callers can allocate exactly once.
+class PercentEncoder {
+public:
+    static size_t encoded_size(std::string_view value, EncodeMode mode = EncodeMode::Query) noexcept;
+
+    // Writes exactly encoded_size(value, mode) bytes and returns the end
+    static char* write(std::string_view value, char* out, EncodeMode mode = EncodeMode::Query) noexcept;
+
+    static std::string encode(std::string_view value, EncodeMode mode = EncodeMode::Query);
+
+    template<typename String>
+    static void append(String& out, std::string_view value, EncodeMode mode = EncodeMode::Query) {
+        const size_t old_size = out.size();
+        const size_t new_size = old_size + encoded_size(value, mode);
+        // Return our own size: some libstdc++ releases pass the capacity to the callback
+        out.resize_and_overwrite(new_size, [&](char* data, size_t) {
+            write(value, data + old_size, mode);
+            return new_size;
+        });
+    }
+};
+
+// Builds `key=value&key=value` from any range of string-like pairs
+// (PARAMS, std::map, vector<pair>...). The size is computed in one
+// pass over the pairs and the output is written in a second, so the result
+// is allocated once.
+class QueryBuilder {
+public:
+    template<typename Pairs>
+    static size_t encoded_size(const Pairs& pairs, EncodeMode mode = EncodeMode::Query) noexcept {
+        size_t size = 0;
+        bool first = true;
+        for (const auto& [key, value] : pairs) {
+            size += (first ? 0 : 1) + PercentEncoder::encoded_size(key, mode) + 1 + PercentEncoder::encoded_size(value, mode);
+            first = false;
+        }
+        return size;
+    }
+
+    // Writes exactly encoded_size(pairs, mode) bytes and returns the end
+    template<typename Pairs>
+    static char* write(const Pairs& pairs, char* out, EncodeMode mode = EncodeMode::Query) noexcept {
+        bool first = true;
+        for (const auto& [key, value] : pairs) {
+            if (!first) *out++ = '&';
+            out = PercentEncoder::write(key, out, mode);
+            *out++ = '=';
+            out = PercentEncoder::write(value, out, mode);
+            first = false;
+        }
+        return out;
+    }
+
+    template<typename String, typename Pairs>
+    static void append(String& out, const Pairs& pairs, EncodeMode mode = EncodeMode::Query) {
+        const size_t old_size = out.size();
+        const size_t new_size = old_size + encoded_size(pairs, mode);
+        out.resize_and_overwrite(new_size, [&](char* data, size_t) {
+            write(pairs, data + old_size, mode);
+            return new_size;
+        });
+    }
+
+    template<typename Pairs>
+    static std::string build(const Pairs& pairs, EncodeMode mode = EncodeMode::Query) {
+        std::string result;
+        append(result, pairs, mode);
+        return result;
+    }
+
+    // application/x-www-form-urlencoded request body
+    template<typename Pairs>
+    static std::string form(const Pairs& pairs) {
+        return build(pairs, EncodeMode::Form);
+    }
+};
+
+} // namespace CurlX
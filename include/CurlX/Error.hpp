@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <curl/curl.h>
+
+namespace CurlX {
+
+// Compact failure code for the non-throwing API (Session::try_send,
+// RESPONSE::try_json): the libcurl result and the phase that failed.
+// Building one costs nothing; the text is looked up only when asked for.
+struct Error {
+    enum class Phase : uint8_t {
+        Setup,    // Invalid request or session; nothing was sent
+        Resolve,  // Host or proxy name lookup
+        Connect,  // TCP connect or TLS handshake
+        Transfer, // Sending the request or receiving the response
+        Body,     // Response body over its limit or could not be stored
+        Parse,    // Response body is not valid JSON
+    };
+
+    CURLcode code{CURLE_OK}; // CURLE_OK when the failure is not libcurl's (Phase::Parse)
+    Phase phase{Phase::Setup};
+
+    std::string_view message() const noexcept;
+    std::string_view phase_name() const noexcept;
+
+    bool is_timeout() const noexcept { return code == CURLE_OPERATION_TIMEDOUT; }
+    bool is_cancelled() const noexcept { return code == CURLE_ABORTED_BY_CALLBACK; }
+    bool is_connection_error() const noexcept {
+        return code == CURLE_COULDNT_CONNECT || code == CURLE_COULDNT_RESOLVE_HOST;
+    }
+
+    // Throw the exception the throwing API raises for this error.
+    // `detail` replaces the default message when given.
+    [[noreturn]] void raise(std::string_view detail = {}) const;
+
+    friend bool operator==(const Error&, const Error&) = default;
+};
+
+static_assert(sizeof(Error) <= 8, "Error is returned by value on hot failure paths");
+
+} // namespace CurlX
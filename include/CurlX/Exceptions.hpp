@@ -31,4 +31,9 @@ public:
     explicit TooManyRedirects(const std::string& message) : RequestException("Too Many Redirects: " + message) {}
 };
 
+class Cancelled : public RequestException {
+public:
+    explicit Cancelled(const std::string& message) : RequestException("Cancelled: " + message) {}
+};
+
 } // namespace CurlX
@@ -19,9 +19,9 @@ namespace CurlX {
     }
 
     // Variadic template GET function (uses a provided session)
-    template<typename... Args>
-    CurlX::RESPONSE GET(Session& session, const URL& url, Args&&... args) {
-        REQUEST request(url, METHOD::GET); // Start with URL and GET method
+    template<typename Policy, typename... Args>
+    CurlX::RESPONSE GET(BasicSession<Policy>& session, const URL& url, Args&&... args) {
+        REQUEST request(url, VERB<METHOD::Verb::GET>{}); // Start with URL and GET method
 
         // Apply each option to the request
         (apply_option(request, std::forward<Args>(args)), ...); // C++17 fold expression
@@ -19,9 +19,9 @@ namespace CurlX {
     }
 
     // Variadic template HEAD function (uses a provided session)
-    template<typename... Args>
-    CurlX::RESPONSE HEAD(Session& session, const URL& url, Args&&... args) {
-        REQUEST request(url, METHOD::HEAD); // Start with URL and HEAD method
+    template<typename Policy, typename... Args>
+    CurlX::RESPONSE HEAD(BasicSession<Policy>& session, const URL& url, Args&&... args) {
+        REQUEST request(url, VERB<METHOD::Verb::HEAD>{}); // Start with URL and HEAD method
 
         // Apply each option to the request
         (apply_option(request, std::forward<Args>(args)), ...); // C++17 fold expression
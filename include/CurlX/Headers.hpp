@@ -4,18 +4,24 @@
 #include <vector>
 #include <optional>
 #include <string_view>
+#include <memory_resource>
 #include <curl/curl.h>
 
 namespace CurlX {
 
 class HEADERS {
 public:
+    using StringType = std::pmr::string;
+    using Storage = std::pmr::vector<StringType>;
+
     // Constructors
     HEADERS() = default;
     explicit HEADERS(size_t initial_capacity);
+    explicit HEADERS(std::pmr::memory_resource* resource);
     
-    // Copy and move operations
+    // Copy and move operations (copies use the default resource unless one is given)
     HEADERS(const HEADERS& other);
+    HEADERS(const HEADERS& other, std::pmr::memory_resource* resource);
     HEADERS(HEADERS&& other) noexcept;
     HEADERS& operator=(const HEADERS& other);
     HEADERS& operator=(HEADERS&& other) noexcept;
@@ -26,11 +32,13 @@ public:
     // Core methods with enhanced safety
     void add(std::string_view key, std::string_view value);
     void add(std::string_view header_line);
+    void add_unchecked(std::string_view header_line); // Caller guarantees a valid "Name: value" line
     void remove(std::string_view header_name);
     std::optional<std::string> get(std::string_view header_name) const;
     
     // Enhanced access methods
-    const std::vector<std::string>& all() const noexcept;
+    const Storage& all() const noexcept;
+    std::pmr::memory_resource* resource() const noexcept;
     
     // CURL integration with safety
     struct curl_slist* to_curl_slist() const;
@@ -43,8 +51,8 @@ public:
     void reserve(size_t capacity);
     
     // Safe iteration
-    std::vector<std::string>::const_iterator begin() const noexcept;
-    std::vector<std::string>::const_iterator end() const noexcept;
+    Storage::const_iterator begin() const noexcept;
+    Storage::const_iterator end() const noexcept;
     
     // Validation
     bool is_valid() const noexcept;
@@ -66,7 +74,7 @@ public:
     }
 
 private:
-    std::vector<std::string> headers_;
+    Storage headers_;
     
     // Internal validation helpers
     bool validate_header_name(std::string_view name) const noexcept;
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "Statistics.hpp"
+
+namespace CurlX {
+
+// HDR-style log-linear buckets for latencies in microseconds: 16 linear
+// sub-buckets per power of two, so a bucket is never wider than 1/16 of its
+// values. Values below 32 us are exact; 2^36 us (19 hours) and above share
+// the last bucket.
+struct LatencyBuckets {
+    static constexpr unsigned SUB_BUCKET_BITS = 4;
+    static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BUCKET_BITS;
+    static constexpr unsigned MAX_BITS = 36;
+    static constexpr size_t COUNT = (MAX_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    static constexpr size_t index(uint64_t micros) noexcept {
+        if (micros >> MAX_BITS) return COUNT - 1;
+        const unsigned width = static_cast<unsigned>(std::bit_width(micros));
+        const unsigned exponent = width > SUB_BUCKET_BITS + 1 ? width - SUB_BUCKET_BITS - 1 : 0;
+        return exponent * SUB_BUCKETS + static_cast<size_t>(micros >> exponent);
+    }
+
+    static constexpr uint64_t lowest(size_t index) noexcept {
+        if (index < 2 * SUB_BUCKETS) return index;
+        const size_t exponent = index / SUB_BUCKETS - 1;
+        return static_cast<uint64_t>(index - exponent * SUB_BUCKETS) << exponent;
+    }
+
+    static constexpr uint64_t highest(size_t index) noexcept {
+        const size_t exponent = index < 2 * SUB_BUCKETS ? 0 : index / SUB_BUCKETS - 1;
+        return lowest(index) + (uint64_t{1} << exponent) - 1;
+    }
+};
+
+// Merged bucket counts, safe to copy and combine
+class LatencySnapshot {
+public:
+    using Duration = std::chrono::microseconds;
+
+    void record(Duration latency) noexcept;
+    void merge(const LatencySnapshot& other) noexcept;
+
+    uint64_t count() const noexcept { return count_; }
+    Duration sum() const noexcept { return Duration(static_cast<Duration::rep>(sum_)); }
+    Duration max() const noexcept { return Duration(static_cast<Duration::rep>(max_)); }
+    Duration mean() const noexcept { return count_ ? Duration(static_cast<Duration::rep>(sum_ / count_)) : Duration(0); }
+
+    // Highest value of the bucket holding the q-th ranked sample (q in [0, 1]),
+    // capped at the largest value seen. Zero if nothing was recorded.
+    Duration percentile(double q) const noexcept;
+    Duration p50() const noexcept { return percentile(0.5); }
+    Duration p90() const noexcept { return percentile(0.9); }
+    Duration p99() const noexcept { return percentile(0.99); }
+    Duration p999() const noexcept { return percentile(0.999); }
+
+    // Samples whose bucket lies entirely at or below `limit`
+    uint64_t count_at_or_below(Duration limit) const noexcept;
+
+    const std::array<uint64_t, LatencyBuckets::COUNT>& buckets() const noexcept { return buckets_; }
+
+private:
+    friend class LatencyHistogram;
+
+    std::array<uint64_t, LatencyBuckets::COUNT> buckets_{};
+    uint64_t count_{0};
+    uint64_t sum_{0};
+    uint64_t max_{0};
+};
+
+// Bucket counters with a single writer: record() is a relaxed load and store
+// per counter, no locked instructions. Any thread may read with add_to().
+class LatencyHistogram {
+public:
+    void record(std::chrono::microseconds latency) noexcept {
+        const uint64_t micros = latency.count() > 0 ? static_cast<uint64_t>(latency.count()) : 0;
+        bump(buckets_[LatencyBuckets::index(micros)], 1);
+        bump(count_, 1);
+        bump(sum_, micros);
+        if (micros > max_.load(std::memory_order_relaxed)) {
+            max_.store(micros, std::memory_order_relaxed);
+        }
+    }
+
+    void add_to(LatencySnapshot& snapshot) const noexcept;
+
+private:
+    static void bump(std::atomic<uint64_t>& counter, uint64_t amount) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<uint64_t>, LatencyBuckets::COUNT> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+// Latency histograms keyed by host, method and status class ("2xx", or
+// "failed" when there was no response).
+//
+// Each thread records into its own shard, so recording takes no lock and
+// shares no cache lines once the thread has seen a key. A thread's first
+// sample for a key allocates its histogram (about 4 KB) under the shard's
+// mutex. snapshot() merges all shards; when a thread exits, its counts are
+// folded into the snapshot totals. Hosts past `max_hosts` are recorded under
+// HostLimit::OTHER_HOST, which bounds the keys and their memory.
+class LatencyStats {
+public:
+    struct Key {
+        std::string host;
+        std::string method;
+        std::string_view status; // Static label
+
+        friend bool operator==(const Key&, const Key&) = default;
+        friend auto operator<=>(const Key&, const Key&) = default;
+    };
+
+    explicit LatencyStats(size_t max_hosts = HostLimit::DEFAULT_MAX_HOSTS);
+    ~LatencyStats();
+    LatencyStats(LatencyStats&& other) noexcept = default;
+    LatencyStats& operator=(LatencyStats&& other) noexcept = default;
+    LatencyStats(const LatencyStats&) = delete;
+    LatencyStats& operator=(const LatencyStats&) = delete;
+
+    void record(std::string_view host, std::string_view method, long status, std::chrono::microseconds latency);
+
+    // Per key, sorted by key
+    std::vector<std::pair<Key, LatencySnapshot>> snapshot() const;
+    // Everything merged
+    LatencySnapshot total() const;
+
+    // Prometheus text exposition: a histogram with coarse `le` buckets, plus
+    // p50/p90/p99/p999 from the fine buckets as a gauge family
+    std::string prometheus(std::string_view name = "curlx_request_duration_seconds") const;
+
+    static std::string_view status_class(long status) noexcept;
+
+private:
+    struct KeyView {
+        std::string_view host;
+        std::string_view method;
+        std::string_view status;
+    };
+    struct KeyHash {
+        using is_transparent = void;
+        size_t operator()(const KeyView& key) const noexcept;
+        size_t operator()(const Key& key) const noexcept { return (*this)(KeyView{key.host, key.method, key.status}); }
+    };
+    struct KeyEqual {
+        using is_transparent = void;
+        static KeyView view(const Key& key) noexcept { return KeyView{key.host, key.method, key.status}; }
+        static const KeyView& view(const KeyView& key) noexcept { return key; }
+        template<typename L, typename R>
+        bool operator()(const L& lhs, const R& rhs) const noexcept {
+            const KeyView& a = view(lhs);
+            const KeyView& b = view(rhs);
+            return a.status == b.status && a.method == b.method && a.host == b.host;
+        }
+    };
+
+    struct Shard;
+    struct Registry;
+    struct ThreadShards;
+
+    Shard& local_shard();
+    static ThreadShards& thread_shards();
+
+    std::shared_ptr<Registry> registry_;
+};
+
+} // namespace CurlX
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+namespace CurlX {
+    // Response size limits, set per Session and optionally overridden per REQUEST
+    struct LIMITS {
+        static constexpr size_t DEFAULT_MAX_BODY_SIZE = 100 * 1024 * 1024; // 100MB
+
+        size_t max_body_size;        // 0 = unlimited
+        size_t spill_threshold;      // Bodies past this size stream to an unlinked temp file; 0 = never spill
+        std::string spill_directory; // Empty = $TMPDIR, falling back to /tmp
+
+        LIMITS(size_t max_body = DEFAULT_MAX_BODY_SIZE, size_t spill_at = 0, std::string directory = "")
+            : max_body_size(max_body), spill_threshold(spill_at), spill_directory(std::move(directory)) {}
+
+        // No size cap; anything past spill_at bytes goes to disk
+        static LIMITS spill_after(size_t spill_at, std::string directory = "") {
+            return LIMITS(0, spill_at, std::move(directory));
+        }
+
+        bool has_body_limit() const { return max_body_size != 0; }
+        bool spills() const { return spill_threshold != 0; }
+    };
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+
+namespace CurlX {
+
+// Process-wide ceiling on buffered response bytes.
+// Sessions register with a shared budget; every in-flight and buffered body
+// is charged against it until the last RESPONSE copy holding it goes away.
+class MemoryBudget {
+public:
+    enum class Overflow {
+        Spill, // Bodies that would exceed the budget continue on disk
+        Delay  // New requests wait until buffered bytes drop below the limit
+    };
+
+    static constexpr size_t DEFAULT_SMALL_BODY_ALLOWANCE = 64 * 1024; // 64KB
+
+    // Each transfer may always buffer `small_body_allowance` bytes in memory,
+    // so small responses never spill or wait. The worst-case ceiling is
+    // limit + small_body_allowance * concurrent transfers.
+    explicit MemoryBudget(size_t limit_bytes,
+                          Overflow policy = Overflow::Spill,
+                          size_t small_body_allowance = DEFAULT_SMALL_BODY_ALLOWANCE);
+
+    MemoryBudget(const MemoryBudget&) = delete;
+    MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+    // Accounting
+    bool try_reserve(size_t bytes) noexcept;
+    void reserve(size_t bytes) noexcept;
+    void release(size_t bytes) noexcept;
+
+    // Admission control: block while the budget is exhausted.
+    // Returns false if the timeout expired first (zero = wait indefinitely).
+    bool wait_for_capacity(std::chrono::milliseconds timeout = std::chrono::milliseconds::zero());
+    // Bounded by a request's remaining time (nullopt = no deadline) and woken
+    // early once `token` is stopped. Returns false if either came first.
+    bool wait_for_capacity(std::optional<std::chrono::milliseconds> timeout, const std::stop_token& token);
+    bool exhausted() const noexcept;
+
+    // Session registration
+    void register_session() noexcept;
+    void unregister_session() noexcept;
+
+    // Monitoring
+    size_t limit() const noexcept { return limit_; }
+    Overflow policy() const noexcept { return policy_; }
+    size_t small_body_allowance() const noexcept { return small_body_allowance_; }
+    size_t used() const noexcept;
+    size_t peak() const noexcept;
+    size_t registered_sessions() const noexcept;
+    size_t spilled_transfers() const noexcept;
+    size_t delayed_requests() const noexcept;
+
+    void record_spill() noexcept;
+
+private:
+    const size_t limit_;
+    const Overflow policy_;
+    const size_t small_body_allowance_;
+
+    std::atomic<size_t> used_{0};
+    std::atomic<size_t> peak_{0};
+    std::atomic<size_t> sessions_{0};
+    std::atomic<size_t> spilled_transfers_{0};
+    std::atomic<size_t> delayed_requests_{0};
+
+    // Only touched when a request actually has to wait
+    std::atomic<size_t> waiters_{0};
+    std::mutex wait_mutex_;
+    std::condition_variable capacity_cv_;
+
+    void update_peak(size_t value) noexcept;
+};
+
+// Bytes charged to a MemoryBudget, released on destruction.
+// A ResponseBody holds its lease so the charge lasts as long as the body does.
+class BudgetLease {
+public:
+    BudgetLease() = default;
+    explicit BudgetLease(std::shared_ptr<MemoryBudget> budget) : budget_(std::move(budget)) {}
+    ~BudgetLease();
+
+    BudgetLease(BudgetLease&& other) noexcept;
+    BudgetLease& operator=(BudgetLease&& other) noexcept;
+    BudgetLease(const BudgetLease&) = delete;
+    BudgetLease& operator=(const BudgetLease&) = delete;
+
+    bool try_grow(size_t bytes) noexcept;
+    void grow(size_t bytes) noexcept;
+    void release() noexcept;
+
+    size_t bytes() const noexcept { return bytes_; }
+    const std::shared_ptr<MemoryBudget>& budget() const noexcept { return budget_; }
+    explicit operator bool() const noexcept { return budget_ != nullptr; }
+
+private:
+    std::shared_ptr<MemoryBudget> budget_;
+    size_t bytes_{0};
+};
+
+} // namespace CurlX
@@ -1,20 +1,58 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 
 namespace CurlX {
+    // HTTP method. The standard verbs are an enum, so dispatch needs no string
+    // compares and copies never allocate; any other token is kept as a custom
+    // string and sent with CURLOPT_CUSTOMREQUEST.
     struct METHOD {
-        std::string value;
+        enum class Verb : uint8_t { GET, POST, PUT, DELETE, PATCH, HEAD, OPTIONS, Custom };
 
-        METHOD(std::string v = "GET") : value(std::move(v)) {}
-        METHOD(const char* v) : value(v) {}
+        constexpr METHOD() noexcept = default;
+        constexpr METHOD(Verb verb) noexcept : verb_(verb) {}
+        METHOD(std::string_view name) { assign(name); }
+        METHOD(const std::string& name) { assign(name); }
+        METHOD(const char* name) { assign(name); }
 
-        METHOD& operator=(std::string_view v) {
-            value = v;
-            return *this;
+        constexpr Verb verb() const noexcept { return verb_; }
+        constexpr bool is_custom() const noexcept { return verb_ == Verb::Custom; }
+
+        std::string_view name() const noexcept {
+            return is_custom() ? std::string_view(custom_) : verb_name(verb_);
+        }
+        const char* c_str() const noexcept {
+            return is_custom() ? custom_.c_str() : verb_name(verb_).data();
+        }
+
+        // Verb names are NUL-terminated literals
+        static constexpr std::string_view verb_name(Verb verb) noexcept {
+            switch (verb) {
+                case Verb::GET: return "GET";
+                case Verb::POST: return "POST";
+                case Verb::PUT: return "PUT";
+                case Verb::DELETE: return "DELETE";
+                case Verb::PATCH: return "PATCH";
+                case Verb::HEAD: return "HEAD";
+                case Verb::OPTIONS: return "OPTIONS";
+                case Verb::Custom: break;
+            }
+            return "";
+        }
+
+        // Method names are case-sensitive; "get" is a custom method
+        static constexpr Verb parse_verb(std::string_view name) noexcept {
+            for (Verb verb : {Verb::GET, Verb::POST, Verb::PUT, Verb::DELETE, Verb::PATCH, Verb::HEAD, Verb::OPTIONS}) {
+                if (verb_name(verb) == name) return verb;
+            }
+            return Verb::Custom;
         }
 
-        const char* c_str() const { return value.c_str(); }
+        friend bool operator==(const METHOD& lhs, const METHOD& rhs) noexcept {
+            return lhs.verb_ == rhs.verb_ && (!lhs.is_custom() || lhs.custom_ == rhs.custom_);
+        }
 
         // Static members for common HTTP methods
         static const METHOD GET;
@@ -24,5 +62,26 @@ namespace CurlX {
         static const METHOD HEAD;
         static const METHOD OPTIONS;
         static const METHOD PATCH;
+
+    private:
+        void assign(std::string_view name) {
+            verb_ = parse_verb(name);
+            if (is_custom()) {
+                custom_.assign(name);
+            } else {
+                custom_.clear();
+            }
+        }
+
+        Verb verb_{Verb::GET};
+        std::string custom_; // Only used for Verb::Custom
+    };
+
+    // Compile-time verb tag carried by the GET/POST/... request templates
+    template<METHOD::Verb V>
+    struct VERB {
+        static constexpr METHOD::Verb value = V;
+        static constexpr std::string_view name = METHOD::verb_name(V);
+        static_assert(V != METHOD::Verb::Custom, "VERB needs a standard HTTP verb");
     };
 }
@@ -19,9 +19,9 @@ namespace CurlX {
     }
 
     // Variadic template OPTIONS function (uses a provided session)
-    template<typename... Args>
-    CurlX::RESPONSE OPTIONS(Session& session, const URL& url, Args&&... args) {
-        REQUEST request(url, METHOD::OPTIONS); // Start with URL and OPTIONS method
+    template<typename Policy, typename... Args>
+    CurlX::RESPONSE OPTIONS(BasicSession<Policy>& session, const URL& url, Args&&... args) {
+        REQUEST request(url, VERB<METHOD::Verb::OPTIONS>{}); // Start with URL and OPTIONS method
 
         // Apply each option to the request
         (apply_option(request, std::forward<Args>(args)), ...); // C++17 fold expression
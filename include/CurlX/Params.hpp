@@ -1,22 +1,124 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <map>
+#include <vector>
+#include <optional>
+#include <cstdint>
+#include <charconv>
+#include <type_traits>
+#include <initializer_list>
+#include <memory_resource>
 
 namespace CurlX {
 
 using StringMap = std::map<std::string, std::string>;
 
-class PARAMS { // Changed to PARAMS
+// Query or form parameters, kept in insertion order.
+// Keys and values are packed into one buffer ("key\0value\0..."), indexed by
+// a flat entry table, so building a PARAMS costs two allocations however many
+// pairs it holds. Repeated keys are kept: add("id", 1).add("id", 2) sends ?id=1&id=2.
+class PARAMS {
 public:
-    PARAMS() = default; // Changed to PARAMS
-    PARAMS(StringMap p) : params_map(std::move(p)) {}
-    PARAMS(const std::initializer_list<std::pair<std::string, std::string>>& init_list) : params_map(init_list.begin(), init_list.end()) {}
+    // One parameter; both views are NUL-terminated inside the buffer
+    struct Param {
+        std::string_view key;
+        std::string_view value;
+    };
 
-    const std::map<std::string, std::string>& get() const { return params_map; }
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Param;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Param;
+
+        const_iterator() = default;
+        const_iterator(const PARAMS* params, size_t index) : params_(params), index_(index) {}
+
+        Param operator*() const { return (*params_)[index_]; }
+        const_iterator& operator++() { ++index_; return *this; }
+        const_iterator operator++(int) { const_iterator copy = *this; ++index_; return copy; }
+        bool operator==(const const_iterator& other) const { return index_ == other.index_; }
+
+    private:
+        const PARAMS* params_{nullptr};
+        size_t index_{0};
+    };
+
+    PARAMS() = default;
+    explicit PARAMS(std::pmr::memory_resource* resource) : buffer_(resource), entries_(resource) {}
+    PARAMS(const StringMap& p);
+    PARAMS(std::initializer_list<std::pair<std::string_view, std::string_view>> init_list);
+
+    // Copies use the default resource unless one is given
+    PARAMS(const PARAMS& other) = default;
+    PARAMS(const PARAMS& other, std::pmr::memory_resource* resource)
+        : buffer_(other.buffer_, resource), entries_(other.entries_, resource) {}
+    PARAMS(PARAMS&& other) = default;
+    PARAMS& operator=(const PARAMS& other) = default;
+    PARAMS& operator=(PARAMS&& other) = default;
+
+    // Append a pair; existing pairs with the same key are kept
+    PARAMS& add(std::string_view key, std::string_view value);
+
+    // Numbers are formatted with std::to_chars straight into the buffer
+    template<typename T>
+        requires (std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>)
+    PARAMS& add(std::string_view key, T value) {
+        const size_t value_offset = append_key(key);
+        const size_t capacity = value_offset + MAX_NUMBER_CHARS + 1;
+        size_t end = value_offset;
+        buffer_.resize_and_overwrite(capacity, [&](char* data, size_t) {
+            end = static_cast<size_t>(std::to_chars(data + value_offset, data + capacity - 1, value).ptr - data);
+            data[end] = '\0';
+            return end + 1;
+        });
+        finish_entry(value_offset, key.size(), end - value_offset);
+        return *this;
+    }
+
+    // Replace every pair with this key by a single one
+    PARAMS& set(std::string_view key, std::string_view value);
+    size_t remove(std::string_view key);
+
+    // Lookup (linear: parameter lists are short and scanned in order)
+    std::optional<std::string_view> get(std::string_view key) const;
+    std::vector<std::string_view> get_all(std::string_view key) const;
+    size_t count(std::string_view key) const;
+    bool contains(std::string_view key) const { return get(key).has_value(); }
+
+    // Flat access in insertion order
+    Param operator[](size_t index) const;
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, entries_.size()); }
+    size_t size() const noexcept { return entries_.size(); }
+    bool empty() const noexcept { return entries_.empty(); }
+
+    void reserve(size_t pairs, size_t bytes = 0);
+    void clear() noexcept;
+
+    // Copy into a std::map (the last value wins for repeated keys)
+    StringMap get() const;
+
+    std::pmr::memory_resource* resource() const { return buffer_.get_allocator().resource(); }
 
 private:
-    std::map<std::string, std::string> params_map;
+    static constexpr size_t MAX_NUMBER_CHARS = 64; // Enough for any double in shortest form
+
+    struct Entry {
+        size_t key_offset;
+        uint32_t key_size;
+        uint32_t value_size; // The value starts right after the key's NUL
+    };
+
+    size_t append_key(std::string_view key); // Returns where the value starts
+    void finish_entry(size_t value_offset, size_t key_size, size_t value_size);
+
+    std::pmr::string buffer_;
+    std::pmr::vector<Entry> entries_;
 };
 
 } // namespace CurlX
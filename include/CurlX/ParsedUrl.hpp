@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <curl/curl.h>
+
+namespace CurlX {
+
+// URL parsed once by libcurl's URL API (CURLU).
+// Components are cached as views into one buffer, and the CURLU handle can be
+// given to libcurl with CURLOPT_CURLU so the transfer does not parse the
+// string again. host_key() identifies the origin for per-host state
+// (pools, rate limits, caches) without any further string parsing.
+class ParsedURL {
+public:
+    struct CurlUrlDeleter {
+        void operator()(CURLU* handle) const noexcept { curl_url_cleanup(handle); }
+    };
+    using Handle = std::unique_ptr<CURLU, CurlUrlDeleter>;
+
+    // Throws RequestException if libcurl rejects the URL.
+    // A missing scheme is guessed as libcurl does ("example.com" -> http).
+    explicit ParsedURL(std::string_view url);
+
+    // Non-throwing form: libcurl's error instead of an exception
+    static std::expected<ParsedURL, CURLUcode> parse(std::string_view url);
+
+    ParsedURL(const ParsedURL& other);
+    ParsedURL& operator=(const ParsedURL& other);
+    ParsedURL(ParsedURL&& other) noexcept = default;
+    ParsedURL& operator=(ParsedURL&& other) noexcept = default;
+    ~ParsedURL() = default;
+
+    // Normalized URL as libcurl will request it
+    std::string_view url() const noexcept { return view(url_); }
+    std::string_view scheme() const noexcept { return view(scheme_); }
+    std::string_view host() const noexcept { return view(host_); }
+    std::string_view path() const noexcept { return view(path_); }
+    std::string_view query() const noexcept { return view(query_); }       // Without '?', empty if none
+    std::string_view fragment() const noexcept { return view(fragment_); } // Without '#', empty if none
+    uint16_t port() const noexcept { return port_; }                        // Scheme default if not explicit
+    bool has_explicit_port() const noexcept { return explicit_port_; }
+
+    // "scheme://host:port" with the scheme and host lowercased
+    std::string_view host_key() const noexcept { return view(host_key_); }
+    size_t host_hash() const noexcept { return host_hash_; }
+    bool same_host(const ParsedURL& other) const noexcept {
+        return host_hash_ == other.host_hash_ && host_key() == other.host_key();
+    }
+
+    // Read-only handle for CURLOPT_CURLU; valid while this object lives
+    CURLU* handle() const noexcept { return handle_.get(); }
+
+    // Independent copy of the handle, e.g. to set a query for one request
+    Handle clone_handle() const;
+
+private:
+    ParsedURL() = default;
+
+    struct Span {
+        uint32_t offset{0};
+        uint32_t size{0};
+    };
+
+    std::string_view view(Span span) const noexcept {
+        return std::string_view(buffer_).substr(span.offset, span.size);
+    }
+    void init_parts(size_t url_size); // Components of the URL in handle_
+    Span append(std::string_view part);
+    Span append_part(CURLUPart part, unsigned int flags = 0);
+
+    Handle handle_;
+    std::string buffer_;
+    Span url_, scheme_, host_, path_, query_, fragment_, host_key_;
+    uint16_t port_{0};
+    bool explicit_port_{false};
+    size_t host_hash_{0};
+};
+
+} // namespace CurlX
@@ -19,9 +19,9 @@ namespace CurlX {
     }
 
     // Variadic template PATCH function (uses a provided session)
-    template<typename... Args>
-    CurlX::RESPONSE PATCH(Session& session, const URL& url, Args&&... args) {
-        REQUEST request(url, METHOD::PATCH); // Start with URL and PATCH method
+    template<typename Policy, typename... Args>
+    CurlX::RESPONSE PATCH(BasicSession<Policy>& session, const URL& url, Args&&... args) {
+        REQUEST request(url, VERB<METHOD::Verb::PATCH>{}); // Start with URL and PATCH method
 
         // Apply each option to the request
         (apply_option(request, std::forward<Args>(args)), ...); // C++17 fold expression
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <stop_token>
+#include <tuple>
+#include <utility>
+#include "Exceptions.hpp"
+#include "Headers.hpp"
+#include "Request.hpp"
+#include "Response.hpp"
+#include "Timeout.hpp"
+
+namespace CurlX {
+
+// An interceptor is any type with
+//
+//   template<typename Next>
+//   RESPONSE intercept(REQUEST& request, Next&& next);
+//
+// It may change the request, call next(request) zero or more times, and
+// inspect or replace the response.
+template<typename T>
+concept Interceptor = requires(T& stage, REQUEST& request, RESPONSE (*next)(REQUEST&)) {
+    { stage.intercept(request, next) } -> std::same_as<RESPONSE>;
+};
+
+// Interceptor chain around a session, composed at compile time:
+//
+//   Pipeline pipeline(session, HeaderStamp("X-Service", "billing"), Retry(3));
+//   RESPONSE response = pipeline.send(std::move(request));
+//
+// Each hop is a direct call the compiler can inline: no virtual dispatch, no
+// std::function and no allocation. Every stage works on the same REQUEST, so
+// the chain never copies it. Pipelines nest, since a Pipeline is itself
+// something with send().
+template<typename Target, Interceptor... Stages>
+class Pipeline {
+public:
+    explicit Pipeline(Target& target, Stages... stages)
+        : target_(target), stages_(std::move(stages)...) {}
+
+    // Stages modify `request` in place
+    RESPONSE send(REQUEST& request) { return run<0>(request); }
+    RESPONSE send(REQUEST&& request) { return run<0>(request); }
+
+    template<size_t I>
+    auto& stage() noexcept { return std::get<I>(stages_); }
+
+    Target& target() noexcept { return target_; }
+
+    static constexpr size_t size() noexcept { return sizeof...(Stages); }
+
+private:
+    template<size_t I>
+    RESPONSE run(REQUEST& request) {
+        if constexpr (I == sizeof...(Stages)) {
+            return target_.send(request);
+        } else {
+            return std::get<I>(stages_).intercept(request, [this](REQUEST& next) { return run<I + 1>(next); });
+        }
+    }
+
+    Target& target_;
+    std::tuple<Stages...> stages_;
+};
+
+// Adds a header unless the request already has one with this name.
+// The line is validated once, here, instead of on every request.
+class HeaderStamp {
+public:
+    HeaderStamp(std::string_view name, std::string_view value) {
+        HEADERS validated;
+        validated.add(name, value);
+        line_ = validated.all().front();
+        name_size_ = name.size();
+    }
+
+    template<typename Next>
+    RESPONSE intercept(REQUEST& request, Next&& next) {
+        if (!present(request.headers_)) {
+            request.headers_.add_unchecked(line_);
+        }
+        return next(request);
+    }
+
+private:
+    bool present(const HEADERS& headers) const noexcept {
+        for (const auto& line : headers.all()) {
+            if (line.size() > name_size_ && line[name_size_] == ':' && same_name(line)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool same_name(std::string_view line) const noexcept {
+        for (size_t i = 0; i < name_size_; ++i) {
+            if (ascii_lower(line[i]) != ascii_lower(line_[i])) return false;
+        }
+        return true;
+    }
+
+    static char ascii_lower(char c) noexcept { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + 32) : c; }
+
+    std::string line_; // "Name: value"
+    size_t name_size_{0};
+};
+
+// Retries connection errors, timeouts and 502/503/504 responses, doubling the
+// delay after each attempt. The request's TIMEOUT becomes one deadline shared
+// by all attempts, and no retry starts that could not finish before it or
+// after the request was cancelled. A stop request during the backoff ends the
+// wait at once with Cancelled.
+// The request must be safe to send more than once.
+class Retry {
+public:
+    explicit Retry(size_t max_attempts = 3, std::chrono::milliseconds backoff = std::chrono::milliseconds(100))
+        : max_attempts_(max_attempts == 0 ? 1 : max_attempts), backoff_(backoff) {}
+
+    template<typename Next>
+    RESPONSE intercept(REQUEST& request, Next&& next) {
+        // The caller's TIMEOUT is restored afterwards, so a reused request keeps its relative limit
+        struct RestoreTimeout {
+            REQUEST& request;
+            TIMEOUT timeout;
+            ~RestoreTimeout() { request.timeout_ = timeout; }
+        } restore{request, request.timeout_};
+        request.timeout_.pin();
+
+        auto delay = backoff_;
+        for (size_t attempt = 1;; ++attempt) {
+            const bool more = attempt < max_attempts_;
+            try {
+                RESPONSE response = next(request);
+                if (!more || !retryable(response.statusCode) || !time_for(delay, request)) {
+                    return response;
+                }
+            } catch (const ConnectionError&) {
+                if (!more || !time_for(delay, request)) throw;
+            } catch (const Timeout&) {
+                if (!more || !time_for(delay, request)) throw;
+            }
+            wait(delay, request.get_stop_token());
+            delay *= 2;
+        }
+    }
+
+    size_t max_attempts() const noexcept { return max_attempts_; }
+
+private:
+    static bool retryable(long status) noexcept { return status == 502 || status == 503 || status == 504; }
+
+    // Sleep for the backoff, woken early by the request's stop token
+    static void wait(std::chrono::milliseconds delay, const std::stop_token& token) {
+        std::mutex mutex;
+        std::condition_variable_any wake;
+        std::unique_lock<std::mutex> lock(mutex);
+        wake.wait_for(lock, token, delay, [] { return false; });
+        if (token.stop_requested()) {
+            throw Cancelled("Request was cancelled while waiting to retry");
+        }
+    }
+
+    // Whether the request is still wanted and its deadline leaves room for
+    // the backoff and another attempt
+    static bool time_for(std::chrono::milliseconds delay, const REQUEST& request) {
+        if (request.get_stop_token().stop_requested()) return false;
+        const auto left = request.timeout_.remaining();
+        return !left || *left > delay;
+    }
+
+    size_t max_attempts_;
+    std::chrono::milliseconds backoff_;
+};
+
+// Calls callback(request, response, seconds) after every response; for
+// logging and metrics. The callable is stored by value and inlined.
+template<typename Callback>
+class Observer {
+public:
+    explicit Observer(Callback callback) : callback_(std::move(callback)) {}
+
+    template<typename Next>
+    RESPONSE intercept(REQUEST& request, Next&& next) {
+        const auto start = std::chrono::steady_clock::now();
+        RESPONSE response = next(request);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        callback_(static_cast<const REQUEST&>(request), static_cast<const RESPONSE&>(response), elapsed.count());
+        return response;
+    }
+
+private:
+    Callback callback_;
+};
+
+} // namespace CurlX
@@ -27,9 +27,9 @@ namespace CurlX {
     }
 
     // Variadic template POST function (uses a provided session)
-    template<typename... Args>
-    CurlX::RESPONSE POST(Session& session, const URL& url, Args&&... args) {
-        REQUEST request(url, METHOD::POST); // Start with URL and POST method
+    template<typename Policy, typename... Args>
+    CurlX::RESPONSE POST(BasicSession<Policy>& session, const URL& url, Args&&... args) {
+        REQUEST request(url, VERB<METHOD::Verb::POST>{}); // Start with URL and POST method
 
         // Apply each option to the request
         (apply_option(request, std::forward<Args>(args)), ...); // C++17 fold expression
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include "Statistics.hpp"
+
+// Static tracepoints (USDT) under the provider "curlx", compiled in when
+// <sys/sdt.h> is available (systemtap-sdt-dev) unless CURLX_NO_USDT is
+// defined. Every probe has a semaphore that tracers increment while
+// attached; an idle probe is one load and a not-taken branch, and its
+// arguments are not computed. bpftrace, perf and SystemTap attach at run time:
+//
+//   bpftrace -e 'usdt:./crawler:curlx:request__done { @ms = hist(arg2 / 1000); }'
+//
+// Probes and arguments (times in microseconds since the request started):
+//
+//   request__start  id, method, url       Handed to libcurl
+//   dns__done       id, lookup_us         Reported once connected (libcurl 7.80+)
+//   connect         id, ip, port, connect_us                  (libcurl 7.80+)
+//   first__byte     id                    First response header line
+//   body__chunk     id, bytes             Each write callback
+//   request__done   id, status, total_us, bytes_received
+//   request__error  id, curlcode, phase   Error::Phase as an integer
+#if !defined(CURLX_NO_USDT) && __has_include(<sys/sdt.h>)
+#ifndef _SDT_HAS_SEMAPHORES
+#define _SDT_HAS_SEMAPHORES 1
+#endif
+#include <sys/sdt.h>
+#define CURLX_HAVE_USDT 1
+
+// Defined in Session.cpp; the probe notes point tracers at them
+extern "C" {
+extern volatile unsigned short curlx_request__start_semaphore;
+extern volatile unsigned short curlx_dns__done_semaphore;
+extern volatile unsigned short curlx_connect_semaphore;
+extern volatile unsigned short curlx_first__byte_semaphore;
+extern volatile unsigned short curlx_body__chunk_semaphore;
+extern volatile unsigned short curlx_request__done_semaphore;
+extern volatile unsigned short curlx_request__error_semaphore;
+}
+
+// True while a tracer is attached to the probe
+#define CURLX_PROBE_ENABLED(name) __builtin_expect(curlx_##name##_semaphore != 0, 0)
+#define CURLX_PROBE(name, ...) \
+    do { if (CURLX_PROBE_ENABLED(name)) { STAP_PROBEV(curlx, name __VA_OPT__(,) __VA_ARGS__); } } while (0)
+#else
+#define CURLX_PROBE_ENABLED(name) false
+#define CURLX_PROBE(name, ...) do {} while (0)
+#endif
+
+namespace CurlX {
+
+// Process-unique id for tracing a request across probes, without a shared
+// counter: the thread's slot in the high bits, a per-thread count below
+inline uint64_t next_request_id() noexcept {
+    thread_local uint64_t count = 0;
+    return (static_cast<uint64_t>(thread_slot()) << 40) | ++count;
+}
+
+} // namespace CurlX
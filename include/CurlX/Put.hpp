@@ -28,9 +28,9 @@ namespace CurlX {
     }
 
     // Variadic template PUT function (uses a provided session)
-    template<typename... Args>
-    CurlX::RESPONSE PUT(Session& session, const URL& url, Args&&... args) {
-        REQUEST request(url, METHOD::PUT); // Start with URL and PUT method
+    template<typename Policy, typename... Args>
+    CurlX::RESPONSE PUT(BasicSession<Policy>& session, const URL& url, Args&&... args) {
+        REQUEST request(url, VERB<METHOD::Verb::PUT>{}); // Start with URL and PUT method
 
         // Apply each option to the request
         (apply_option(request, std::forward<Args>(args)), ...); // C++17 fold expression
@@ -2,6 +2,8 @@
 
 #include <string>
 #include <functional>
+#include <optional>
+#include <stop_token>
 #include "Url.hpp"
 #include "Headers.hpp"
 #include "Body.hpp"
@@ -15,6 +17,7 @@
 #include "Method.hpp"
 #include "Params.hpp"
 #include "Files.hpp"
+#include "Limits.hpp"
 
 #include "Session.hpp"
 
@@ -51,6 +54,10 @@ namespace CurlX {
               files_(std::move(f)),
               output_file_path_(std::move(ofp)) {}
 
+        // Verb fixed at compile time (used by the GET/POST/... templates)
+        template<METHOD::Verb V>
+        REQUEST(const URL& u, VERB<V>) : url_(u), method_(V) {}
+
         // Chainable setters
         REQUEST& url(const URL& u) { url_ = u; return *this; }
         REQUEST& method(const METHOD& m) { method_ = m; return *this; }
@@ -64,6 +71,8 @@ namespace CurlX {
         REQUEST& redirects(const REDIRECTS& r) { allow_redirects_ = r; return *this; }
         REQUEST& verify(const VERIFY& v) { verify_ = v; return *this; }
         REQUEST& files(const FILES& f) { files_ = f; return *this; }
+        REQUEST& limits(const LIMITS& l) { limits_ = l; return *this; }
+        REQUEST& cancel_on(std::stop_token token) { stop_token_ = std::move(token); return *this; }
         REQUEST& output_file_path(const std::string& ofp) { output_file_path_ = ofp; return *this; }
         REQUEST& write_callback(WriteCallback cb, void* userdata = nullptr) { write_cb_ = cb; write_userdata_ = userdata; return *this; }
         REQUEST& read_callback(ReadCallback cb, void* userdata = nullptr) { read_cb_ = cb; read_userdata_ = userdata; return *this; }
@@ -92,6 +101,8 @@ namespace CurlX {
         const REDIRECTS& get_redirects() const { return allow_redirects_; }
         const VERIFY& get_verify() const { return verify_; }
         const FILES& get_files() const { return files_; }
+        const std::optional<LIMITS>& get_limits() const { return limits_; }
+        const std::stop_token& get_stop_token() const { return stop_token_; }
         const std::string& get_output_file_path() const { return output_file_path_; }
 
     // All members are public by default in a struct
@@ -107,6 +118,8 @@ namespace CurlX {
         VERIFY verify_;
         PARAMS params_;
         FILES files_;
+        std::optional<LIMITS> limits_; // Unset = use the Session limits
+        std::stop_token stop_token_;   // A stop request aborts the transfer in flight
         std::string output_file_path_;
         WriteCallback write_cb_ = nullptr;
         void* write_userdata_ = nullptr;
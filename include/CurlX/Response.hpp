@@ -5,10 +5,18 @@
 #include <memory>
 #include <chrono>
 #include <optional>
+#include <expected>
 #include "Headers.hpp"
 #include "Url.hpp"
 #include "Exceptions.hpp"
+#include "Error.hpp"
 #include "Cookies.hpp"
+#include "ResponseBody.hpp"
+#include "Limits.hpp"
+#include "Timings.hpp"
+#include "Traffic.hpp"
+#include "CpuTime.hpp"
+#include "DebugCapture.hpp"
 #include <stdexcept>
 #include <nlohmann/json.hpp>
 
@@ -24,6 +32,8 @@ public:
     explicit RESPONSE(long status_code);
     RESPONSE(long status_code, std::string body);
     RESPONSE(long status_code, std::string body, HEADERS headers);
+    // Headers and cookies allocate from `resource`; copies go back to the default resource
+    explicit RESPONSE(std::pmr::memory_resource* resource);
     
     // Copy and move operations
     RESPONSE(const RESPONSE& other);
@@ -40,11 +50,15 @@ public:
     URL url;            // Final URL after redirects
     bool is_redirect{false};   // True if the response was a redirect
     HEADERS headers;
-    std::string body;
+    ResponseBody body;  // Shared, immutable: copying a RESPONSE never copies the payload
     URL request_url; // The URL that was requested
     HEADERS request_headers; // The headers that were sent with the request
     COOKIES received_cookies; // Cookies received in the response
     double elapsed_time{0.0};      // Time taken for the request in seconds
+    TIMINGS timings;               // Per-phase breakdown of elapsed_time
+    TRAFFIC traffic;               // Bytes sent and received, on the wire and decoded
+    CPU_TIME cpu_time;             // Thread CPU time in the library, with Session::set_cpu_accounting
+    std::shared_ptr<const DebugTrace> debug_trace; // libcurl's verbose output, when DEBUG_CAPTURE kept the request
     std::vector<URL> history; // Redirect history
     
     // Additional safety and performance fields
@@ -75,11 +89,12 @@ public:
     
     // Safe content access methods
     std::string text() const noexcept;
-    std::string_view text_view() const noexcept;
+    std::string_view text_view() const; // Flattens a segmented body
     
     // Enhanced JSON parsing with safety
     nlohmann::json json() const;
     std::optional<nlohmann::json> json_safe() const noexcept;
+    std::expected<nlohmann::json, Error> try_json() const; // Parse errors as Error::Phase::Parse, no exception
     
     // Performance and monitoring methods
     double get_response_time() const noexcept;
@@ -118,8 +133,8 @@ public:
     void compress_if_beneficial();
     
     // Debugging and diagnostics
-    std::string get_debug_info() const;
-    void log_performance_metrics() const;
+    std::string get_debug_info() const;       // Status, URLs, timings, traffic, headers and any debug trace
+    void log_performance_metrics() const;     // One key=value line to std::clog
     
     // Memory management
     void clear_body();
@@ -141,13 +156,13 @@ private:
     void optimize_cookies();
     
     // Safety constants
-    static constexpr size_t MAX_BODY_SIZE = 100 * 1024 * 1024; // 100MB
+    static constexpr size_t MAX_BODY_SIZE = LIMITS::DEFAULT_MAX_BODY_SIZE; // Session/REQUEST LIMITS override it
     static constexpr size_t MAX_HEADERS_SIZE = 64 * 1024; // 64KB
     static constexpr size_t MAX_URL_LENGTH = 2048; // 2KB
     static constexpr double MAX_RESPONSE_TIME = 3600.0; // 1 hour
     
     // Internal state
-    mutable std::optional<nlohmann::json> cached_json_;
+    mutable std::shared_ptr<const nlohmann::json> cached_json_; // Shared between copies like the body
     mutable bool content_type_detected_{false};
     mutable bool optimized_{false};
 };
@@ -164,6 +179,9 @@ namespace ResponseUtils {
     bool is_safe_response_size(size_t size) noexcept;
     
     // Performance helpers
+    // Decoded body bytes per byte on the wire, both directions and headers
+    // included: above 1 when compression saves more than the headers cost.
+    // 0 if nothing was recorded.
     double calculate_response_efficiency(const RESPONSE& response);
     size_t estimate_memory_footprint(const RESPONSE& response);
     
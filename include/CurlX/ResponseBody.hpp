@@ -0,0 +1,189 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+#include <ostream>
+#include "MemoryBudget.hpp"
+
+namespace CurlX {
+
+// How a Session accumulates response bodies while a transfer is in flight
+enum class BodyStorage {
+    Contiguous, // One growing std::string (default)
+    Segmented   // Fixed-size pooled blocks, flattened only on demand
+};
+
+// Process-wide pool of fixed-size body blocks.
+// Released blocks are kept for reuse up to a cap, so back-to-back large
+// downloads do not go back to malloc for every block.
+class BodyBlockPool {
+public:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024; // 64KB
+    static constexpr size_t DEFAULT_MAX_CACHED_BLOCKS = 256; // 16MB
+
+    static BodyBlockPool& instance();
+
+    std::unique_ptr<char[]> acquire();
+    void release(std::unique_ptr<char[]> block) noexcept;
+
+    void set_max_cached_blocks(size_t max_blocks);
+    size_t cached_blocks() const noexcept;
+    void trim() noexcept;
+
+private:
+    BodyBlockPool() = default;
+
+    mutable std::mutex pool_mutex_;
+    std::vector<std::unique_ptr<char[]>> free_blocks_;
+    size_t max_cached_blocks_{DEFAULT_MAX_CACHED_BLOCKS};
+};
+
+// Append-only list of pooled blocks.
+// Appending never moves bytes that were already received, so peak memory
+// stays at roughly the body size plus one block.
+class SegmentedBuffer {
+public:
+    SegmentedBuffer() = default;
+    ~SegmentedBuffer();
+
+    SegmentedBuffer(SegmentedBuffer&& other) noexcept;
+    SegmentedBuffer& operator=(SegmentedBuffer&& other) noexcept;
+    SegmentedBuffer(const SegmentedBuffer&) = delete;
+    SegmentedBuffer& operator=(const SegmentedBuffer&) = delete;
+
+    void append(const char* data, size_t length);
+    void clear() noexcept;
+
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    size_t block_count() const noexcept { return blocks_.size(); }
+
+    // Filled part of every block, in order
+    std::vector<std::span<const char>> spans() const;
+
+    // Copy into one contiguous string
+    std::string flatten() const;
+
+private:
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t used{0};
+    };
+
+    std::vector<Block> blocks_;
+    size_t size_{0};
+};
+
+// Read-only memory mapping of a spilled body, unmapped on destruction
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map the first `size` bytes of an open file descriptor
+    static MappedFile map(int fd, size_t size);
+
+    std::string_view view() const noexcept;
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+private:
+    void* address_{nullptr};
+    size_t size_{0};
+};
+
+// Unlinked temporary file that receives a body once it passes the spill threshold.
+// The file has no name on disk, so it disappears with the last descriptor or mapping.
+class SpillFile {
+public:
+    explicit SpillFile(const std::string& directory = "");
+    ~SpillFile();
+
+    SpillFile(SpillFile&& other) noexcept;
+    SpillFile& operator=(SpillFile&& other) noexcept;
+    SpillFile(const SpillFile&) = delete;
+    SpillFile& operator=(const SpillFile&) = delete;
+
+    void write(const char* data, size_t length);
+    size_t size() const noexcept { return size_; }
+
+    // Finish writing and map the contents read-only; the descriptor is closed
+    MappedFile map();
+
+private:
+    void close() noexcept;
+
+    int fd_{-1};
+    size_t size_{0};
+};
+
+// Immutable, reference-counted response body.
+// Copies share one buffer, so a RESPONSE can be handed to several consumers
+// (cache, logger, business logic) without duplicating the payload.
+// A body built from a SegmentedBuffer keeps its blocks until the first time
+// contiguous access (view(), data(), begin()) is needed. It is then flattened
+// and the blocks go back to the pool, so only one copy stays in memory.
+// A body built from a MappedFile is a zero-copy view of a spilled temp file.
+class ResponseBody {
+public:
+    static constexpr size_t npos = std::string_view::npos;
+
+    ResponseBody() = default;
+    ResponseBody(std::string body);
+    ResponseBody(std::string_view body);
+    ResponseBody(const char* body);
+    explicit ResponseBody(SegmentedBuffer segments);
+    explicit ResponseBody(MappedFile mapping);
+
+    // Zero-copy access. Flattens a segmented body once, which allocates and may throw.
+    std::string_view view() const;
+    operator std::string_view() const { return view(); }
+    const char* data() const { return view().data(); }
+    size_t size() const noexcept;
+    size_t length() const noexcept { return size(); }
+    bool empty() const noexcept { return size() == 0; }
+    std::string_view substr(size_t pos, size_t count = npos) const;
+
+    std::string_view::const_iterator begin() const { return view().begin(); }
+    std::string_view::const_iterator end() const { return view().end(); }
+
+    // Chunk access without flattening. The spans of a segmented body are only
+    // valid until it is flattened, like iterators into a container.
+    bool is_segmented() const noexcept;
+    bool is_mapped() const noexcept;
+    std::vector<std::span<const char>> spans() const;
+
+    // Explicit deep copy; does not flatten a segmented body
+    std::string str() const;
+
+    // Sharing diagnostics
+    long use_count() const noexcept;
+    bool shares_buffer_with(const ResponseBody& other) const noexcept;
+
+    // Keep a memory budget charge until the last copy of this body is destroyed
+    void hold(BudgetLease lease);
+
+    // Hidden friends: only considered when a ResponseBody is actually involved,
+    // so unrelated string_view comparisons never convert through ResponseBody
+    friend bool operator==(const ResponseBody& body, std::string_view other) {
+        return body.view() == other;
+    }
+
+    // Writes a segmented body block by block without flattening it
+    friend std::ostream& operator<<(std::ostream& os, const ResponseBody& body);
+
+private:
+    struct Storage;
+    std::shared_ptr<Storage> storage_;
+};
+
+} // namespace CurlX
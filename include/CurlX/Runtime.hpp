@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <curl/curl.h>
+
+namespace CurlX {
+
+// Allocation hooks handed to curl_global_init_mem.
+// All five must be set; libcurl requires them to be thread-safe.
+struct CurlAllocator {
+    curl_malloc_callback malloc_fn{nullptr};
+    curl_free_callback free_fn{nullptr};
+    curl_realloc_callback realloc_fn{nullptr};
+    curl_strdup_callback strdup_fn{nullptr};
+    curl_calloc_callback calloc_fn{nullptr};
+
+    bool complete() const noexcept {
+        return malloc_fn && free_fn && realloc_fn && strdup_fn && calloc_fn;
+    }
+};
+
+// Counters for libcurl's allocations (built-in allocators only).
+// Each thread counts in its own shard; allocation_stats() adds them up.
+struct AllocationStats {
+    size_t allocations{0};       // malloc, calloc, strdup and reallocs that moved the block
+    size_t frees{0};
+    size_t reallocations{0};
+    size_t bytes_allocated{0};   // Total requested over the process lifetime
+    size_t bytes_in_use{0};
+    size_t peak_bytes_in_use{0}; // Highest of any one thread's peak and every total read so far
+    size_t cache_hits{0};        // Pooled allocator: served from a thread cache
+};
+
+// Process-wide libcurl initialization.
+// Session calls ensure_initialized(), so explicit initialization is only
+// needed to pick an allocator. It must happen before the first Session is
+// created, while no other threads are using libcurl.
+class Runtime {
+public:
+    enum class Allocator {
+        System,   // libcurl's default malloc/free, no statistics
+        Counting, // malloc/free with per-call accounting
+        Pooled    // Size-class blocks with per-thread caches, plus accounting
+    };
+
+    static constexpr size_t MAX_POOLED_SIZE = 4096;        // Larger requests go to malloc
+    static constexpr size_t THREAD_CACHE_BLOCKS = 64;      // Cached blocks per size class and thread
+
+    static void initialize(Allocator allocator = Allocator::System, long flags = CURL_GLOBAL_ALL);
+    static void initialize(const CurlAllocator& allocator, long flags = CURL_GLOBAL_ALL);
+    static void ensure_initialized();
+
+    static bool is_initialized() noexcept;
+    static Allocator allocator() noexcept;
+    static bool has_custom_allocator() noexcept;
+
+    // All zero unless a built-in Counting or Pooled allocator is active
+    static AllocationStats allocation_stats() noexcept;
+
+    Runtime() = delete;
+};
+
+} // namespace CurlX
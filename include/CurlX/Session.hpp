@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Error.hpp"
 #include "Response.hpp"
 #include "Url.hpp"
 #include "Headers.hpp"
@@ -12,7 +13,14 @@
 #include "Verify.hpp"
 #include "Body.hpp"
 #include "Files.hpp"
+#include "Limits.hpp"
+#include "MemoryBudget.hpp"
+#include "LatencyHistogram.hpp"
+#include "Statistics.hpp"
+#include "DebugCapture.hpp"
 #include <curl/curl.h>
+#include <expected>
+#include <stop_token>
 #include <memory>
 #include <atomic>
 #include <mutex>
@@ -20,6 +28,8 @@
 #include <future>
 #include <chrono>
 #include <functional>
+#include <memory_resource>
+#include <optional>
 
 namespace CurlX {
 
@@ -29,25 +39,58 @@ struct REQUEST;
 // Thread-safe session pool for connection reuse
 class SessionPool;
 
-class Session {
+// Event loop over a session's requests (AsyncSession.hpp)
+template<typename Policy>
+class BasicAsyncSession;
+
+// Compile-time switches for the defensive work a session does on every request
+struct DefaultPolicy {
+    static constexpr bool validate_requests = true;   // Session state, URL and output directory checks
+    static constexpr bool validate_headers = true;    // Re-validate merged request and received response header lines
+    static constexpr bool guard_callbacks = true;     // Argument checks and try/catch in libcurl callbacks
+    static constexpr bool enforce_limits = true;      // LIMITS and the MemoryBudget on response bodies
+    static constexpr bool collect_statistics = true;  // Request count and average response time
+};
+
+// Minimal hot path for service-to-service calls whose inputs the caller built
+// itself: no validation, no limits or budget, no statistics. An exception inside
+// a libcurl callback (e.g. out of memory) terminates instead of failing the request.
+struct TrustedPolicy {
+    static constexpr bool validate_requests = false;
+    static constexpr bool validate_headers = false;
+    static constexpr bool guard_callbacks = false;
+    static constexpr bool enforce_limits = false;
+    static constexpr bool collect_statistics = false;
+};
+
+// Session parameterized by a policy. Only DefaultPolicy and TrustedPolicy are
+// instantiated (in Session.cpp).
+template<typename Policy = DefaultPolicy>
+class BasicSession {
 public:
+    using policy_type = Policy;
+    
     // Constructor with enhanced safety
-    explicit Session(bool enable_connection_pooling = true);
+    explicit BasicSession(bool enable_connection_pooling = true);
     
     // Move constructor and assignment for performance
-    Session(Session&& other) noexcept;
-    Session& operator=(Session&& other) noexcept;
+    BasicSession(BasicSession&& other) noexcept;
+    BasicSession& operator=(BasicSession&& other) noexcept;
     
     // Delete copy constructor/assignment for safety
-    Session(const Session&) = delete;
-    Session& operator=(const Session&) = delete;
+    BasicSession(const BasicSession&) = delete;
+    BasicSession& operator=(const BasicSession&) = delete;
     
     // Destructor with enhanced cleanup
-    ~Session();
+    ~BasicSession();
 
     // Core request method with enhanced safety
     CurlX::RESPONSE send(const REQUEST& request);
     
+    // Non-throwing send: failures come back as a compact Error instead of an exception.
+    // Setup failures carry Error::Phase::Setup, including running out of memory.
+    std::expected<RESPONSE, Error> try_send(const REQUEST& request);
+    
     // Async version for non-blocking operations
     std::future<CurlX::RESPONSE> send_async(const REQUEST& request);
 
@@ -96,15 +139,43 @@ public:
     // Performance tuning methods
     void set_connection_timeout(double seconds);
     void set_transfer_timeout(double seconds);
+    // Abort transfers that move fewer than min_bytes_per_second over `window` (0 = off; TIMEOUT::stall overrides)
+    void set_stall_detection(size_t min_bytes_per_second, std::chrono::milliseconds window);
+    // Concurrent connections to one host, for transfers on a multi handle
+    // (AsyncSession, cancellable requests); CURLMOPT_MAX_HOST_CONNECTIONS, 0 = no limit
     void set_max_connections_per_host(size_t max_conns);
+    // Idle connections kept open for reuse, over all hosts (CURLOPT_MAXCONNECTS)
+    void set_connection_cache_size(size_t connections);
     void set_keep_alive(bool enable);
     void set_compression(bool enable);
+    void set_body_storage(BodyStorage storage);
+    void set_request_arena(bool enable); // Per-thread arena for transient request strings (default on)
+    
+    // Response size limits and spill-to-disk (REQUEST::limits overrides per request)
+    void set_limits(const LIMITS& limits);
+    const LIMITS& get_limits() const noexcept;
+    
+    // Shared ceiling on buffered response bytes across sessions
+    void set_memory_budget(std::shared_ptr<MemoryBudget> budget);
+    std::shared_ptr<MemoryBudget> get_memory_budget() const;
     
     // Safety and monitoring methods
     bool is_valid() const noexcept;
     void reset() noexcept;
     size_t get_request_count() const noexcept;
     double get_average_response_time() const noexcept;
+    // Request, error, byte and time totals
+    STATISTICS get_statistics() const noexcept;
+    // Latency distribution by host, method and status class
+    const LatencyStats& get_latency_stats() const noexcept;
+    // Bytes on the wire and decoded, per host
+    const TrafficStats& get_traffic_stats() const noexcept;
+    // Connections opened, reused and closed, per host
+    const ConnectionStats& get_connection_stats() const noexcept;
+    // Keep libcurl's verbose output for slow or failed requests only; std::nullopt turns it off
+    void set_debug_capture(std::optional<DEBUG_CAPTURE> capture);
+    // Per-request thread CPU time by phase, in RESPONSE::cpu_time and STATISTICS (default off)
+    void set_cpu_accounting(bool enable);
     
     // Connection pooling
     void enable_connection_pooling(bool enable = true);
@@ -114,16 +185,20 @@ public:
     CURL* get_curl_handle() const noexcept;
 
 private:
+    friend class BasicAsyncSession<Policy>;
+    
     // Enhanced private members with safety features
     std::unique_ptr<CURL, std::function<void(CURL*)>> curl_handle_;
+    std::unique_ptr<CURLM, std::function<void(CURLM*)>> multi_handle_; // Only for cancellable requests
     HEADERS default_headers_;
     COOKIES default_cookies_;
     std::string cookie_jar_path_;
     
     // Performance monitoring
-    std::atomic<size_t> request_count_{0};
-    std::atomic<double> total_response_time_{0.0};
-    mutable std::mutex stats_mutex_;
+    SessionCounters counters_;
+    LatencyStats latency_stats_;
+    TrafficStats traffic_stats_;
+    ConnectionStats connection_stats_; // Socket callbacks point here; curl handles must go first
     
     // Connection pooling
     std::shared_ptr<SessionPool> connection_pool_;
@@ -136,17 +211,46 @@ private:
     // Performance settings
     double connection_timeout_{30.0};
     double transfer_timeout_{60.0};
+    size_t stall_min_bytes_per_second_{0};
+    std::chrono::milliseconds stall_window_{0};
     size_t max_connections_per_host_{10};
+    size_t connection_cache_size_{10};
     bool keep_alive_enabled_{true};
     bool compression_enabled_{true};
+    BodyStorage body_storage_{BodyStorage::Contiguous};
+    bool request_arena_enabled_{true};
+    LIMITS limits_;
+    std::shared_ptr<MemoryBudget> memory_budget_;
+    std::shared_ptr<const DEBUG_CAPTURE> debug_capture_; // Shared with transfers in flight
+    bool cpu_accounting_{false};
     
     // Private helper methods
+    std::expected<RESPONSE, Error> perform(const REQUEST& request, std::string* detail);
+    CURLcode perform_cancellable(CURL* handle, const std::stop_token& token);
+    
+    // perform() in steps, so AsyncSession can run transfers on its own multi handle
+    struct Transfer;
+    struct TransferDeleter {
+        void operator()(Transfer* transfer) const noexcept;
+    };
+    using TransferPtr = std::unique_ptr<Transfer, TransferDeleter>;
+    TransferPtr new_transfer(CURL* handle, const REQUEST& request, std::shared_ptr<MemoryBudget> budget,
+                             std::pmr::memory_resource* transient);
+    std::optional<Error> prepare_transfer(Transfer& transfer, std::string* detail);
+    std::expected<RESPONSE, Error> finish_transfer(Transfer& transfer, CURLcode res, std::string* detail);
+    std::expected<RESPONSE, Error> build_response(Transfer& transfer, CURLcode res, std::string* detail);
+    // Call without session_mutex_ held, after finish_transfer
+    static void deliver_debug_trace(Transfer& transfer) noexcept;
+    TRAFFIC transfer_traffic(const Transfer& transfer) const;
+    
     void initialize_curl_handle();
     void cleanup_curl_handle() noexcept;
-    void validate_request(const REQUEST& request) const;
-    void apply_performance_settings();
-    void apply_safety_settings();
-    void update_statistics(double response_time);
+    std::optional<Error> validate_request(const REQUEST& request, std::string* detail) const;
+    void apply_performance_settings(CURL* handle);
+    void apply_safety_settings(CURL* handle);
+    // `transfer` once the request reached libcurl, for its byte and connection counts
+    void update_statistics(const REQUEST& request, const Transfer* transfer, CURLcode result, long status,
+                           std::chrono::microseconds elapsed);
     
     // Thread-safe operations
     template<typename Func>
@@ -157,8 +261,19 @@ private:
     public:
         void operator()(CURL* handle) const noexcept;
     };
+    
+    class CurlMultiDeleter {
+    public:
+        void operator()(CURLM* multi) const noexcept;
+    };
 };
 
+using Session = BasicSession<DefaultPolicy>;
+using TrustedSession = BasicSession<TrustedPolicy>;
+
+extern template class BasicSession<DefaultPolicy>;
+extern template class BasicSession<TrustedPolicy>;
+
 // Thread-safe session pool for connection reuse
 class SessionPool {
 public:
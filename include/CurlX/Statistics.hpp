@@ -0,0 +1,225 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <curl/curl.h>
+#include "CpuTime.hpp"
+#include "Traffic.hpp"
+
+namespace CurlX {
+
+// Session totals, added up from SessionCounters when read
+struct STATISTICS {
+    uint64_t requests{0};
+    uint64_t failures{0};       // Requests that ended with a CURLcode other than CURLE_OK
+    uint64_t bytes_sent{0};     // Request line, headers and body (CURLINFO_REQUEST_SIZE)
+    uint64_t bytes_received{0}; // Response headers and body as received
+    std::chrono::microseconds total_time{0};
+    CPU_TIME cpu_time;                        // Summed; zero unless Session::set_cpu_accounting is on
+    std::array<uint64_t, CURL_LAST> errors{}; // Failures by CURLcode
+
+    uint64_t errors_for(CURLcode code) const noexcept {
+        return code >= 0 && code < CURL_LAST ? errors[code] : 0;
+    }
+    double average_response_time() const noexcept { // Seconds
+        return requests ? std::chrono::duration<double>(total_time).count() / static_cast<double>(requests) : 0.0;
+    }
+};
+
+// A small number per thread, handed out round-robin on first use, that
+// picks the thread's shard in striped counters
+inline size_t thread_slot() noexcept {
+    constinit static std::atomic<size_t> next{0};
+    thread_local size_t slot = SIZE_MAX; // Constant-initialized: no guard check per call
+    if (slot == SIZE_MAX) [[unlikely]] {
+        slot = next.fetch_add(1, std::memory_order_relaxed) & SIZE_MAX >> 1;
+    }
+    return slot;
+}
+
+// Lets string-keyed maps be searched with a string_view
+struct StringHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view text) const noexcept { return std::hash<std::string_view>{}(text); }
+};
+
+// Bounds the hosts a per-host statistic keeps apart. The first `max_hosts`
+// hosts seen get their own entries; later ones are counted under OTHER_HOST,
+// so a crawler that touches 100k hosts does not grow the maps without limit.
+class HostLimit {
+public:
+    static constexpr size_t DEFAULT_MAX_HOSTS = 1024;
+    static constexpr std::string_view OTHER_HOST = "other"; // Never a host_key()
+
+    explicit HostLimit(size_t max_hosts = DEFAULT_MAX_HOSTS) : max_hosts_(max_hosts) {}
+
+    // `host` if it has its own entry, or OTHER_HOST once the limit is reached.
+    // Callers only need this when `host` is not in their map yet.
+    std::string_view admit(std::string_view host);
+
+    size_t max_hosts() const noexcept { return max_hosts_; }
+
+private:
+    const size_t max_hosts_;
+    std::shared_mutex mutex_;
+    std::unordered_set<std::string, StringHash, std::equal_to<>> hosts_;
+};
+
+// Shards for striped counters: the hardware thread count rounded up to a
+// power of two, at most 64
+size_t counter_shards() noexcept;
+
+// Request counters striped across cache-line-padded shards. Each thread
+// adds to its own shard with relaxed fetch_add, so threads on different
+// cores never write the same cache line; read() adds the shards up.
+// There are as many shards as hardware threads (up to 64), so beyond that
+// threads share shards round-robin.
+class SessionCounters {
+public:
+    SessionCounters();
+    SessionCounters(SessionCounters&&) noexcept = default;
+    SessionCounters& operator=(SessionCounters&&) noexcept = default;
+
+    void record(CURLcode result, uint64_t bytes_sent, uint64_t bytes_received,
+                std::chrono::microseconds elapsed, const CPU_TIME& cpu = {}) noexcept {
+        if (!shards_) return; // Moved from
+        Shard& shard = shards_[thread_slot() & mask_];
+        shard.requests.fetch_add(1, std::memory_order_relaxed);
+        shard.bytes_sent.fetch_add(bytes_sent, std::memory_order_relaxed);
+        shard.bytes_received.fetch_add(bytes_received, std::memory_order_relaxed);
+        shard.micros.fetch_add(elapsed.count() > 0 ? static_cast<uint64_t>(elapsed.count()) : 0, std::memory_order_relaxed);
+        if (cpu.total().count() > 0) {
+            shard.cpu_setup.fetch_add(static_cast<uint64_t>(cpu.setup.count()), std::memory_order_relaxed);
+            shard.cpu_callbacks.fetch_add(static_cast<uint64_t>(cpu.callbacks.count()), std::memory_order_relaxed);
+            shard.cpu_post.fetch_add(static_cast<uint64_t>(cpu.post.count()), std::memory_order_relaxed);
+            shard.cpu_libcurl.fetch_add(static_cast<uint64_t>(cpu.libcurl.count()), std::memory_order_relaxed);
+        }
+        if (result != CURLE_OK) {
+            shard.errors[result >= 0 && result < CURL_LAST ? result : CURLE_FAILED_INIT].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    STATISTICS read() const noexcept;
+    uint64_t requests() const noexcept;
+
+private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    struct alignas(CACHE_LINE) Shard {
+        std::atomic<uint64_t> requests{0};
+        std::atomic<uint64_t> bytes_sent{0};
+        std::atomic<uint64_t> bytes_received{0};
+        std::atomic<uint64_t> micros{0};
+        std::atomic<uint64_t> cpu_setup{0}; // Nanoseconds
+        std::atomic<uint64_t> cpu_callbacks{0};
+        std::atomic<uint64_t> cpu_post{0};
+        std::atomic<uint64_t> cpu_libcurl{0};
+        std::array<std::atomic<uint64_t>, CURL_LAST> errors{};
+    };
+
+    std::unique_ptr<Shard[]> shards_;
+    size_t mask_{0};
+};
+
+// TRAFFIC summed per host (ParsedURL::host_key()). Each thread adds to its
+// own shard, a mutex-guarded map, so the mutex is only contended while a
+// snapshot is being taken. Hosts past `max_hosts` share HostLimit::OTHER_HOST.
+class TrafficStats {
+public:
+    struct Host {
+        std::string host;
+        uint64_t requests{0};
+        TRAFFIC traffic;
+    };
+
+    explicit TrafficStats(size_t max_hosts = HostLimit::DEFAULT_MAX_HOSTS);
+    TrafficStats(TrafficStats&&) noexcept = default;
+    TrafficStats& operator=(TrafficStats&&) noexcept = default;
+
+    void record(std::string_view host, const TRAFFIC& traffic);
+
+    // Sorted by host
+    std::vector<Host> snapshot() const;
+    TRAFFIC total() const;
+
+private:
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, Host, StringHash, std::equal_to<>> hosts;
+    };
+
+    std::unique_ptr<Shard[]> shards_;
+    size_t mask_{0};
+    std::unique_ptr<HostLimit> limit_;
+};
+
+// Connection lifecycle per host, from CURLOPT_OPENSOCKETFUNCTION and
+// CURLOPT_CLOSESOCKETFUNCTION: connections opened and closed, how long they
+// lived, and how many requests each one served.
+//
+// Sockets are counted under the host of the request that opened them (the
+// proxy's connections too). Socket events take one mutex, as they are rare;
+// per-request counts go to striped shards like TrafficStats. Hosts past
+// `max_hosts` share HostLimit::OTHER_HOST.
+class ConnectionStats {
+private:
+    struct State;
+
+public:
+    struct Host {
+        std::string host;
+        uint64_t opened{0};
+        uint64_t closed{0};
+        uint64_t requests{0};  // Requests that reached libcurl
+        uint64_t reused{0};    // Of those, the ones that opened no connection
+        std::chrono::microseconds lifetime{0}; // Summed over closed connections
+        std::chrono::microseconds longest{0};
+
+        uint64_t open() const noexcept { return opened - closed; }
+        double requests_per_connection() const noexcept {
+            return opened ? static_cast<double>(requests) / static_cast<double>(opened) : 0.0;
+        }
+        std::chrono::microseconds average_lifetime() const noexcept {
+            return closed ? lifetime / static_cast<std::chrono::microseconds::rep>(closed) : std::chrono::microseconds(0);
+        }
+    };
+
+    // Per-transfer data for CURLOPT_OPENSOCKETDATA, alive until the transfer ends
+    struct Tap {
+        State* state{nullptr};
+        std::string_view host;
+    };
+
+    explicit ConnectionStats(size_t max_hosts = HostLimit::DEFAULT_MAX_HOSTS);
+    ~ConnectionStats();
+    ConnectionStats(ConnectionStats&&) noexcept;
+    ConnectionStats& operator=(ConnectionStats&&) noexcept;
+
+    // Set the socket callbacks on `handle` for a transfer to `host`. Connections
+    // outlive transfers, so this object must outlive every connection cache
+    // that holds them.
+    void attach(CURL* handle, Tap& tap, std::string_view host) const noexcept;
+    void record_request(std::string_view host, bool reused);
+
+    // Sorted by host
+    std::vector<Host> snapshot() const;
+
+private:
+    static curl_socket_t open_socket(void* tap, curlsocktype purpose, curl_sockaddr* address) noexcept;
+    static int close_socket(void* state, curl_socket_t socket) noexcept;
+
+    std::unique_ptr<State> state_;
+};
+
+} // namespace CurlX
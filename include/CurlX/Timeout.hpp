@@ -1,11 +1,76 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <optional>
+
 namespace CurlX {
+    // Per-request time limits, applied with millisecond precision.
+    //
+    //   TIMEOUT(std::chrono::milliseconds(250))              // Whole request, redirects included
+    //   TIMEOUT::at(deadline)                                // Absolute: shared by retries
+    //   TIMEOUT(2).connect_within(std::chrono::milliseconds(50)).stall(1024, std::chrono::seconds(2))
+    //
+    // Unset limits fall back to the Session settings.
     struct TIMEOUT {
-        long seconds;
+        using Clock = std::chrono::steady_clock;
+
+        std::chrono::milliseconds total{0};       // 0 = session transfer timeout
+        std::chrono::milliseconds connect{0};     // 0 = session connection timeout
+        std::optional<Clock::time_point> deadline;
+
+        // Stall detection: abort when fewer than min_bytes_per_second move over stall_window
+        size_t min_bytes_per_second{0};
+        std::chrono::milliseconds stall_window{0};
+
+        TIMEOUT(long s = 0L) : total(std::chrono::seconds(s)) {}
+
+        template<typename Rep, typename Period>
+        TIMEOUT(std::chrono::duration<Rep, Period> limit)
+            : total(std::chrono::ceil<std::chrono::milliseconds>(limit)) {}
+
+        static TIMEOUT at(Clock::time_point deadline) {
+            TIMEOUT timeout;
+            timeout.deadline = deadline;
+            return timeout;
+        }
+
+        TIMEOUT& connect_within(std::chrono::milliseconds limit) { connect = limit; return *this; }
+        TIMEOUT& stall(size_t bytes_per_second, std::chrono::milliseconds window) {
+            min_bytes_per_second = bytes_per_second;
+            stall_window = window;
+            return *this;
+        }
+
+        // Turn the relative limit into a deadline from now, so every later
+        // send (redirects, retries) draws on the same budget
+        TIMEOUT& pin(Clock::time_point now = Clock::now()) {
+            if (total.count() > 0) {
+                const Clock::time_point pinned = now + total;
+                deadline = deadline ? std::min(*deadline, pinned) : pinned;
+                total = std::chrono::milliseconds(0);
+            }
+            return *this;
+        }
+
+        bool has_limit() const { return total.count() > 0 || deadline.has_value(); }
+        bool detects_stalls() const { return min_bytes_per_second > 0 && stall_window.count() > 0; }
 
-        TIMEOUT(long s = 0L) : seconds(s) {}
+        // Time left at `now`: the smaller of the relative limit and the deadline.
+        // nullopt if there is no limit; zero once the deadline has passed.
+        std::optional<std::chrono::milliseconds> remaining(Clock::time_point now = Clock::now()) const {
+            std::optional<std::chrono::milliseconds> left;
+            if (total.count() > 0) left = total;
+            if (deadline) {
+                const auto until = std::chrono::ceil<std::chrono::milliseconds>(*deadline - now);
+                const auto clamped = std::max(until, std::chrono::milliseconds(0));
+                left = left ? std::min(*left, clamped) : clamped;
+            }
+            return left;
+        }
 
-        long value() const { return seconds; }
+        // Whole seconds, as the former public `seconds` member held
+        long value() const { return static_cast<long>(std::chrono::duration_cast<std::chrono::seconds>(total).count()); }
     };
 }
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace CurlX {
+
+// Hierarchical timer wheel with 1 ms ticks: four levels of 64 slots cover
+// 64^4 ms (about 4.6 hours) ahead, later timers wait in an overflow list.
+//
+//   TimerWheel wheel;
+//   TimerWheel::TimerId id = wheel.schedule_after(std::chrono::milliseconds(250), [] { ... });
+//   wheel.cancel(id);
+//   wheel.advance(); // Runs the callbacks that are due
+//
+// schedule() and cancel() are O(1): a timer is a node in an intrusive list,
+// and nodes are recycled through a free list. A timer moves down a level at
+// most three times before it fires. Timers never fire early; they fire at
+// the first advance() at or after their expiry, rounded up to the next tick.
+// Not thread-safe: one thread owns the wheel.
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Callback = std::move_only_function<void()>;
+
+    // Handle for cancel(). Stale ids (fired or cancelled timers) are detected
+    // by a generation count, so a recycled node is never cancelled by mistake.
+    struct TimerId {
+        uint32_t index{0};
+        uint32_t generation{0}; // 0 = no timer
+
+        explicit operator bool() const noexcept { return generation != 0; }
+        friend bool operator==(const TimerId&, const TimerId&) = default;
+    };
+
+    static constexpr size_t LEVELS = 4;
+    static constexpr size_t SLOT_BITS = 6;
+    static constexpr size_t SLOTS = size_t{1} << SLOT_BITS;
+
+    explicit TimerWheel(Clock::time_point origin = Clock::now());
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    TimerId schedule(Clock::time_point when, Callback callback);
+    TimerId schedule_after(std::chrono::milliseconds delay, Callback callback) {
+        return schedule(Clock::now() + delay, std::move(callback));
+    }
+
+    // False if the timer already fired or was cancelled
+    bool cancel(TimerId id) noexcept;
+
+    // Run every timer due at `now`. Timers scheduled by these callbacks for
+    // `now` or earlier run on the next call. Returns the number fired.
+    size_t advance(Clock::time_point now = Clock::now());
+
+    // Earliest time advance() may have work: never later than the next expiry,
+    // but possibly earlier, when a far timer only moves down a level.
+    // nullopt when no timer is pending.
+    std::optional<Clock::time_point> next_expiry() const noexcept;
+
+    // Milliseconds until next_expiry() (0 if due), or -1 if none: an epoll_wait timeout
+    int poll_timeout(Clock::time_point now = Clock::now()) const noexcept;
+
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+private:
+    static constexpr uint32_t NIL = UINT32_MAX;
+    static constexpr uint64_t NO_TICK = UINT64_MAX;
+
+    // Lists a node can be on, besides the level slots 0..LEVELS-1
+    enum : uint8_t { READY = LEVELS, OVERFLOW_LIST, FIRING, FREE };
+
+    struct Node {
+        uint64_t expiry{0};
+        Callback callback;
+        uint32_t prev{NIL};
+        uint32_t next{NIL};
+        uint32_t generation{1};
+        uint8_t list{FREE};
+        uint8_t slot{0};
+    };
+
+    uint64_t to_tick(Clock::time_point when) const noexcept;
+    uint64_t next_event_tick() const noexcept;
+
+    uint32_t& head(uint8_t list, uint8_t slot) noexcept;
+    void link(uint32_t index, uint8_t list, uint8_t slot) noexcept;
+    void unlink(uint32_t index) noexcept;
+    void place(uint32_t index) noexcept;
+    void cascade(uint8_t list, uint8_t slot) noexcept;
+    void release(uint32_t index) noexcept;
+    size_t fire_ready();
+
+    Clock::time_point origin_;
+    uint64_t now_tick_{0};
+    std::vector<Node> nodes_;
+    uint32_t free_{NIL};
+    std::array<std::array<uint32_t, SLOTS>, LEVELS> slots_;
+    std::array<uint64_t, LEVELS> occupied_{}; // Bit per non-empty slot
+    uint32_t ready_{NIL};
+    uint32_t overflow_{NIL};
+    uint32_t firing_{NIL};
+    size_t size_{0};
+};
+
+} // namespace CurlX
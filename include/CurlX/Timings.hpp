@@ -0,0 +1,40 @@
+#pragma once
+
+#include <chrono>
+
+namespace CurlX {
+    // Where a request's time went, from libcurl's CURLINFO_*_TIME_T values.
+    // Each point is measured from the start of the request, so they add up:
+    //
+    //   name_lookup <= connect <= app_connect <= pre_transfer <= start_transfer <= total
+    //
+    // For a reused connection the lookup, connect and TLS points are zero or
+    // close to it. With redirects, the points cover the last request only and
+    // `redirect` holds the time spent on the earlier ones.
+    struct TIMINGS {
+        using Duration = std::chrono::microseconds;
+
+        Duration name_lookup{0};    // DNS resolved
+        Duration connect{0};        // TCP (or proxy) connection established
+        Duration app_connect{0};    // TLS handshake done; 0 for plain HTTP
+        Duration pre_transfer{0};   // About to send the request
+        Duration start_transfer{0}; // First response byte received (TTFB)
+        Duration total{0};
+        Duration redirect{0};       // All redirect steps before the final request
+        long new_connections{0};    // Connections opened for this request (CURLINFO_NUM_CONNECTS)
+
+        bool reused_connection() const noexcept { return new_connections == 0; }
+
+        // Length of each phase
+        Duration dns() const noexcept { return name_lookup; }
+        Duration tcp() const noexcept { return since(connect, name_lookup); }
+        Duration tls() const noexcept { return app_connect.count() > 0 ? since(app_connect, connect) : Duration(0); }
+        Duration server() const noexcept { return since(start_transfer, pre_transfer); } // Waiting for the first byte
+        Duration download() const noexcept { return since(total, start_transfer); }
+
+    private:
+        static Duration since(Duration end, Duration start) noexcept {
+            return end > start ? end - start : Duration(0);
+        }
+    };
+}
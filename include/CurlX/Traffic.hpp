@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+namespace CurlX {
+    // Bytes a request moved, from libcurl's counters and the body as stored.
+    // With redirects, the header and request counts include every step.
+    struct TRAFFIC {
+        uint64_t request_headers{0};  // Request line and headers (CURLINFO_REQUEST_SIZE less the body)
+        uint64_t request_body{0};     // CURLINFO_SIZE_UPLOAD_T
+        uint64_t response_headers{0}; // CURLINFO_HEADER_SIZE
+        uint64_t wire_body{0};        // Response body on the wire, still compressed (CURLINFO_SIZE_DOWNLOAD_T)
+        uint64_t decoded_body{0};     // Response body after Content-Encoding was removed
+
+        uint64_t sent() const noexcept { return request_headers + request_body; }
+        uint64_t received() const noexcept { return response_headers + wire_body; }
+        uint64_t wire() const noexcept { return sent() + received(); }
+
+        // Decoded body bytes per body byte on the wire; 1.0 without compression
+        double compression_ratio() const noexcept {
+            return wire_body ? static_cast<double>(decoded_body) / static_cast<double>(wire_body) : 1.0;
+        }
+
+        TRAFFIC& operator+=(const TRAFFIC& other) noexcept {
+            request_headers += other.request_headers;
+            request_body += other.request_body;
+            response_headers += other.response_headers;
+            wire_body += other.wire_body;
+            decoded_body += other.decoded_body;
+            return *this;
+        }
+
+        friend bool operator==(const TRAFFIC&, const TRAFFIC&) = default;
+    };
+}
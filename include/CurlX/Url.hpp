@@ -1,6 +1,11 @@
 #pragma once
 #include <string>
 #include <string_view>
+#include <memory>
+#include <atomic>
+#include <expected>
+#include <ostream>
+#include "ParsedUrl.hpp"
 
 namespace CurlX {
     class URL {
@@ -8,17 +13,43 @@ namespace CurlX {
         URL() = default;
         URL(std::string_view url) : url_str(url) {}
         URL(const char* url) : url_str(url) {}
+        URL(std::string&& url) : url_str(std::move(url)) {}
+
+        URL(const URL& other) : url_str(other.url_str), parsed_(other.parsed_.load(std::memory_order_acquire)) {}
+        URL(URL&& other) noexcept : url_str(std::move(other.url_str)), parsed_(other.parsed_.exchange(nullptr)) {}
+        URL& operator=(const URL& other) {
+            if (this != &other) {
+                url_str = other.url_str;
+                parsed_.store(other.parsed_.load(std::memory_order_acquire), std::memory_order_release);
+            }
+            return *this;
+        }
+        URL& operator=(URL&& other) noexcept {
+            if (this != &other) {
+                url_str = std::move(other.url_str);
+                parsed_.store(other.parsed_.exchange(nullptr), std::memory_order_release);
+            }
+            return *this;
+        }
 
         URL& operator=(std::string_view url) {
             url_str = url;
+            parsed_.store(nullptr, std::memory_order_release);
             return *this;
         }
 
         const std::string& toString() const { return url_str; }
         const char* c_str() const { return url_str.c_str(); }
 
+        // Parsed form, computed on first use and shared by copies of this URL.
+        // Throws RequestException if the URL is invalid.
+        std::shared_ptr<const ParsedURL> parsed() const;
+        // Same, with libcurl's error for an invalid URL instead of an exception
+        std::expected<std::shared_ptr<const ParsedURL>, CURLUcode> try_parsed() const;
+
     private:
         std::string url_str;
+        mutable std::atomic<std::shared_ptr<const ParsedURL>> parsed_;
     };
 
     inline std::ostream& operator<<(std::ostream& os, const URL& url) {
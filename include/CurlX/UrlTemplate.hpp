@@ -0,0 +1,184 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "Encoding.hpp"
+#include "Url.hpp"
+
+namespace CurlX {
+
+// String literal usable as a template argument
+template<size_t N>
+struct FixedString {
+    char data[N]{};
+
+    constexpr FixedString(const char (&str)[N]) {
+        for (size_t i = 0; i < N; ++i) {
+            data[i] = str[i];
+        }
+    }
+
+    constexpr std::string_view view() const { return std::string_view(data, N - 1); }
+};
+
+// URL pattern parsed at compile time into literal segments and {named} slots:
+//
+//   using ItemUrl = URL_TEMPLATE<"https://api.example.com/{tenant}/items/{id}">;
+//   URL url = ItemUrl::expand("acme corp", 42); // .../acme%20corp/items/42
+//
+// Slot values are percent-encoded (a '/' in a value stays inside its segment).
+// Numbers are formatted with std::to_chars. The output is sized exactly
+// before it is written, so expansion allocates once.
+template<FixedString Pattern>
+class URL_TEMPLATE {
+    struct Range {
+        size_t offset{0};
+        size_t size{0};
+    };
+
+    static constexpr size_t count_slots() {
+        const std::string_view pattern = Pattern.view();
+        size_t slots = 0;
+        bool open = false;
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            if (pattern[i] == '{') {
+                if (open) throw "URL_TEMPLATE: nested '{'";
+                if (i + 1 < pattern.size() && pattern[i + 1] == '}') throw "URL_TEMPLATE: empty slot name";
+                open = true;
+            } else if (pattern[i] == '}') {
+                if (!open) throw "URL_TEMPLATE: unmatched '}'";
+                open = false;
+                ++slots;
+            }
+        }
+        if (open) throw "URL_TEMPLATE: unterminated '{'";
+        return slots;
+    }
+
+public:
+    static constexpr size_t SLOT_COUNT = count_slots();
+
+private:
+    struct Layout {
+        std::array<Range, SLOT_COUNT + 1> literals{}; // Text before each slot, and after the last
+        std::array<Range, SLOT_COUNT> slots{};        // Slot names, without braces
+        size_t literal_size{0};
+    };
+
+    static constexpr Layout parse() {
+        const std::string_view pattern = Pattern.view();
+        Layout layout;
+        size_t slot = 0;
+        size_t literal_start = 0;
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            if (pattern[i] == '{') {
+                layout.literals[slot] = Range{literal_start, i - literal_start};
+                size_t close = i + 1;
+                while (pattern[close] != '}') ++close; // count_slots() guarantees a match
+                layout.slots[slot] = Range{i + 1, close - i - 1};
+                ++slot;
+                i = close;
+                literal_start = close + 1;
+            }
+        }
+        layout.literals[SLOT_COUNT] = Range{literal_start, pattern.size() - literal_start};
+        for (const Range& literal : layout.literals) {
+            layout.literal_size += literal.size;
+        }
+        return layout;
+    }
+
+    static constexpr Layout LAYOUT = parse();
+
+    // A slot argument ready to be measured and written
+    struct SlotValue {
+        static constexpr size_t MAX_NUMBER_CHARS = 64;
+
+        std::string_view text;
+        bool encode{true};
+        char number[MAX_NUMBER_CHARS];
+
+        template<typename T>
+        explicit SlotValue(const T& value) {
+            if constexpr (std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>) {
+                const auto result = std::to_chars(number, number + MAX_NUMBER_CHARS, value);
+                text = std::string_view(number, static_cast<size_t>(result.ptr - number));
+                // Integers are digits and '-', all unreserved. Floating-point values
+                // can carry '+' ("1e+20"), which would decode as a space in a query.
+                encode = std::is_floating_point_v<T>;
+            } else {
+                static_assert(std::is_convertible_v<const T&, std::string_view>,
+                              "URL_TEMPLATE slot values must be strings or numbers");
+                text = value;
+            }
+        }
+
+        SlotValue(const SlotValue&) = delete;
+        SlotValue& operator=(const SlotValue&) = delete;
+
+        size_t size() const noexcept { return encode ? PercentEncoder::encoded_size(text) : text.size(); }
+        char* write(char* out) const noexcept {
+            if (encode) return PercentEncoder::write(text, out);
+            return std::copy(text.begin(), text.end(), out);
+        }
+    };
+
+    static char* write_literal(size_t index, char* out) noexcept {
+        const Range& literal = LAYOUT.literals[index];
+        const std::string_view pattern = Pattern.view();
+        return std::copy(pattern.begin() + literal.offset, pattern.begin() + literal.offset + literal.size, out);
+    }
+
+    template<typename String, size_t... I>
+    static void append_values(String& out, const SlotValue* values, std::index_sequence<I...>) {
+        size_t size = out.size() + LAYOUT.literal_size;
+        ((size += values[I].size()), ...);
+
+        const size_t old_size = out.size();
+        out.resize(size);
+        char* cursor = out.data() + old_size;
+        ((cursor = write_literal(I, cursor), cursor = values[I].write(cursor)), ...);
+        write_literal(SLOT_COUNT, cursor);
+    }
+
+public:
+    static constexpr std::string_view pattern() { return Pattern.view(); }
+    static constexpr size_t slot_count() { return SLOT_COUNT; }
+    static constexpr std::string_view slot_name(size_t index) {
+        return Pattern.view().substr(LAYOUT.slots[index].offset, LAYOUT.slots[index].size);
+    }
+
+    // Append the expanded URL to `out` (std::string or std::pmr::string)
+    template<typename String, typename... Args>
+        requires (sizeof...(Args) == SLOT_COUNT)
+    static void append(String& out, const Args&... args) {
+        if constexpr (SLOT_COUNT == 0) {
+            out.append(Pattern.view());
+        } else {
+            const SlotValue values[] = {SlotValue(args)...};
+            append_values(out, values, std::make_index_sequence<SLOT_COUNT>{});
+        }
+    }
+
+    template<typename... Args>
+        requires (sizeof...(Args) == SLOT_COUNT)
+    static std::string expand_string(const Args&... args) {
+        std::string result;
+        append(result, args...);
+        return result;
+    }
+
+    template<typename... Args>
+        requires (sizeof...(Args) == SLOT_COUNT)
+    static URL expand(const Args&... args) {
+        return URL(expand_string(args...));
+    }
+};
+
+} // namespace CurlX
@@ -0,0 +1,43 @@
+#include "CurlX/Arena.hpp"
+
+namespace CurlX {
+
+namespace {
+    struct ThreadArena {
+        alignas(std::max_align_t) std::byte buffer[RequestArena::INLINE_BUFFER_SIZE];
+        // Overflow past the inline buffer goes straight to operator new, not to
+        // whatever default resource the application installed
+        std::pmr::monotonic_buffer_resource resource{buffer, sizeof(buffer), std::pmr::new_delete_resource()};
+        size_t depth{0};
+    };
+
+    ThreadArena& thread_arena() noexcept {
+        thread_local ThreadArena arena;
+        return arena;
+    }
+}
+
+RequestArena::Scope::Scope() noexcept {
+    ++thread_arena().depth;
+}
+
+RequestArena::Scope::~Scope() {
+    ThreadArena& arena = thread_arena();
+    if (--arena.depth == 0) {
+        arena.resource.release(); // Back to the inline buffer
+    }
+}
+
+std::pmr::memory_resource* RequestArena::Scope::resource() const noexcept {
+    return &thread_arena().resource;
+}
+
+std::pmr::memory_resource* RequestArena::current() noexcept {
+    return &thread_arena().resource;
+}
+
+size_t RequestArena::depth() noexcept {
+    return thread_arena().depth;
+}
+
+} // namespace CurlX
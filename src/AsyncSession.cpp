@@ -0,0 +1,419 @@
+#include "CurlX/AsyncSession.hpp"
+#include "CurlX/Exceptions.hpp"
+#include "CurlX/Runtime.hpp"
+#include <cerrno>
+#include <memory_resource>
+#include <optional>
+#include <stop_token>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace CurlX {
+
+// Posts a stop request to the loop thread
+template<typename Policy>
+struct BasicAsyncSession<Policy>::CancelRequest {
+    BasicAsyncSession* self;
+    uint64_t id;
+
+    void operator()() const noexcept {
+        {
+            std::lock_guard<std::mutex> lock(self->queue_mutex_);
+            self->cancelled_.push_back(id);
+        }
+        self->wake();
+    }
+};
+
+// A request from submit() until its completion has run
+template<typename Policy>
+struct BasicAsyncSession<Policy>::Job {
+    Job(REQUEST&& r, Done&& d) : request(std::move(r)), done(std::move(d)) {}
+
+    REQUEST request;
+    Done done;
+    uint64_t id{0};
+    EasyHandle handle;
+    typename session_type::TransferPtr transfer;
+    TimerWheel::TimerId deadline;
+    std::optional<std::stop_callback<CancelRequest>> cancel;
+    std::chrono::steady_clock::time_point start_time{std::chrono::steady_clock::now()};
+    std::string detail;
+};
+
+template<typename Policy>
+BasicAsyncSession<Policy>::BasicAsyncSession(session_type& session) : session_(session) {
+    Runtime::ensure_initialized();
+
+    epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    CURLM* multi = curl_multi_init();
+    if (multi) {
+        multi_handle_.reset(multi);
+    }
+    if (epoll_fd_ < 0 || wake_fd_ < 0 || !multi_handle_) {
+        if (wake_fd_ >= 0) ::close(wake_fd_);
+        if (epoll_fd_ >= 0) ::close(epoll_fd_);
+        throw RequestException("Failed to initialize the async event loop");
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = wake_fd_;
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event);
+
+    curl_multi_setopt(multi, CURLMOPT_SOCKETFUNCTION, &BasicAsyncSession::socket_callback);
+    curl_multi_setopt(multi, CURLMOPT_SOCKETDATA, this);
+    curl_multi_setopt(multi, CURLMOPT_TIMERFUNCTION, &BasicAsyncSession::timer_callback);
+    curl_multi_setopt(multi, CURLMOPT_TIMERDATA, this);
+
+    loop_ = std::jthread([this](std::stop_token stop) { run(stop); });
+}
+
+template<typename Policy>
+BasicAsyncSession<Policy>::~BasicAsyncSession() {
+    loop_.request_stop();
+    wake();
+    loop_.join();
+
+    // The loop has exited: fail whatever is left on this thread
+    std::vector<std::unique_ptr<Job>> pending;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        pending.swap(submitted_);
+    }
+    for (auto& job : pending) {
+        fail(std::move(job), Error{CURLE_ABORTED_BY_CALLBACK, Error::Phase::Setup}, "AsyncSession was destroyed");
+    }
+    while (!jobs_.empty()) {
+        Job& job = *jobs_.begin()->second;
+        job.detail = "AsyncSession was destroyed";
+        complete(job, CURLE_ABORTED_BY_CALLBACK);
+    }
+
+    idle_handles_.clear();
+    multi_handle_.reset();
+    ::close(wake_fd_);
+    ::close(epoll_fd_);
+}
+
+template<typename Policy>
+std::future<RESPONSE> BasicAsyncSession<Policy>::send(REQUEST request) {
+    std::promise<RESPONSE> promise;
+    std::future<RESPONSE> future = promise.get_future();
+    submit(std::move(request), [promise = std::move(promise)](std::expected<RESPONSE, Error>&& result,
+                                                               const std::string& detail) mutable {
+        if (result) {
+            promise.set_value(std::move(*result));
+            return;
+        }
+        try {
+            result.error().raise(detail);
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+    });
+    return future;
+}
+
+template<typename Policy>
+void BasicAsyncSession<Policy>::send(REQUEST request, Completion on_done) {
+    submit(std::move(request), [on_done = std::move(on_done)](std::expected<RESPONSE, Error>&& result,
+                                                               const std::string&) mutable {
+        on_done(std::move(result));
+    });
+}
+
+template<typename Policy>
+void BasicAsyncSession<Policy>::after(std::chrono::milliseconds delay, std::move_only_function<void()> callback) {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        timers_.emplace_back(TimerWheel::Clock::now() + delay, std::move(callback));
+    }
+    wake();
+}
+
+template<typename Policy>
+void BasicAsyncSession<Policy>::submit(REQUEST&& request, Done done) {
+    auto job = std::make_unique<Job>(std::move(request), std::move(done));
+    in_flight_.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        submitted_.push_back(std::move(job));
+    }
+    wake();
+}
+
+template<typename Policy>
+void BasicAsyncSession<Policy>::wake() noexcept {
+    const uint64_t one = 1;
+    [[maybe_unused]] const ssize_t written = ::write(wake_fd_, &one, sizeof(one));
+}
+
+// libcurl asks to watch a socket for reading and/or writing
+template<typename Policy>
+int BasicAsyncSession<Policy>::socket_callback(CURL*, curl_socket_t socket, int what, void* userp, void*) noexcept {
+    auto* self = static_cast<BasicAsyncSession*>(userp);
+    if (what == CURL_POLL_REMOVE) {
+        ::epoll_ctl(self->epoll_fd_, EPOLL_CTL_DEL, socket, nullptr);
+        return 0;
+    }
+    epoll_event event{};
+    event.events = ((what & CURL_POLL_IN) ? EPOLLIN : 0u) | ((what & CURL_POLL_OUT) ? EPOLLOUT : 0u);
+    event.data.fd = socket;
+    if (::epoll_ctl(self->epoll_fd_, EPOLL_CTL_MOD, socket, &event) != 0 && errno == ENOENT) {
+        ::epoll_ctl(self->epoll_fd_, EPOLL_CTL_ADD, socket, &event);
+    }
+    return 0;
+}
+
+// libcurl keeps a single timer per multi handle; it lives in the wheel.
+// The wheel only raises a flag: curl_multi_socket_action runs after advance().
+template<typename Policy>
+int BasicAsyncSession<Policy>::timer_callback(CURLM*, long timeout_ms, void* userp) noexcept {
+    auto* self = static_cast<BasicAsyncSession*>(userp);
+    self->wheel_.cancel(self->curl_timer_);
+    self->curl_timer_ = {};
+    if (timeout_ms >= 0) {
+        try {
+            self->curl_timer_ = self->wheel_.schedule_after(std::chrono::milliseconds(timeout_ms), [self] {
+                self->curl_timer_ = {};
+                self->curl_timer_due_ = true;
+            });
+        } catch (const std::exception&) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+template<typename Policy>
+void BasicAsyncSession<Policy>::run(std::stop_token stop) {
+    constexpr int MAX_EVENTS = 256;
+    epoll_event events[MAX_EVENTS];
+    CURLM* multi = multi_handle_.get();
+    int running = 0;
+
+    while (!stop.stop_requested()) {
+        drain_commands();
+
+        const int ready = ::epoll_wait(epoll_fd_, events, MAX_EVENTS, wheel_.poll_timeout());
+        for (int i = 0; i < ready; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == wake_fd_) {
+                uint64_t count = 0;
+                [[maybe_unused]] const ssize_t got = ::read(wake_fd_, &count, sizeof(count));
+                continue;
+            }
+            int flags = 0;
+            if (events[i].events & EPOLLIN) flags |= CURL_CSELECT_IN;
+            if (events[i].events & EPOLLOUT) flags |= CURL_CSELECT_OUT;
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) flags |= CURL_CSELECT_ERR;
+            curl_multi_socket_action(multi, fd, flags, &running);
+        }
+
+        wheel_.advance();
+        if (curl_timer_due_) {
+            curl_timer_due_ = false;
+            curl_multi_socket_action(multi, CURL_SOCKET_TIMEOUT, 0, &running);
+        }
+        collect_completions();
+    }
+}
+
+// New requests, timers and cancellations from other threads
+template<typename Policy>
+void BasicAsyncSession<Policy>::drain_commands() {
+    std::vector<std::unique_ptr<Job>> submitted;
+    std::vector<std::pair<TimerWheel::Clock::time_point, std::move_only_function<void()>>> timers;
+    std::vector<uint64_t> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        submitted.swap(submitted_);
+        timers.swap(timers_);
+        cancelled.swap(cancelled_);
+    }
+
+    for (uint64_t id : cancelled) {
+        const auto it = jobs_.find(id);
+        if (it != jobs_.end()) {
+            complete(*it->second, CURLE_ABORTED_BY_CALLBACK);
+        }
+    }
+    for (auto& [when, callback] : timers) {
+        wheel_.schedule(when, std::move(callback));
+    }
+    for (auto& job : submitted) {
+        start(std::move(job));
+    }
+}
+
+template<typename Policy>
+void BasicAsyncSession<Policy>::start(std::unique_ptr<Job> job) {
+    const REQUEST& request = job->request;
+    if (request.get_stop_token().stop_requested()) {
+        fail(std::move(job), Error{CURLE_ABORTED_BY_CALLBACK, Error::Phase::Setup}, "Request was cancelled before it started");
+        return;
+    }
+
+    std::optional<Error> failed;
+    std::optional<std::chrono::milliseconds> limit;
+    try {
+        if constexpr (Policy::validate_requests) {
+            failed = session_.validate_request(request, &job->detail);
+        }
+
+        if (failed) {
+            // Reported below
+        } else if (!idle_handles_.empty()) {
+            job->handle = std::move(idle_handles_.back());
+            idle_handles_.pop_back();
+        } else {
+            job->handle.reset(curl_easy_init());
+            if (!job->handle) {
+                failed = Error{CURLE_FAILED_INIT, Error::Phase::Setup};
+                job->detail = "Failed to initialize CURL handle";
+            }
+        }
+
+        if (!failed) {
+            std::lock_guard<std::mutex> lock(session_.session_mutex_);
+            std::shared_ptr<MemoryBudget> budget;
+            if constexpr (Policy::enforce_limits) {
+                budget = session_.memory_budget_;
+            }
+            job->transfer = session_.new_transfer(job->handle.get(), request, std::move(budget), std::pmr::get_default_resource());
+            failed = session_.prepare_transfer(*job->transfer, &job->detail);
+
+            // Follows set_max_connections_per_host calls made after construction
+            if (session_.max_connections_per_host_ != max_host_connections_) {
+                max_host_connections_ = session_.max_connections_per_host_;
+                curl_multi_setopt(multi_handle_.get(), CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(max_host_connections_));
+            }
+
+            // The overall limit is a wheel timer instead of libcurl's per-handle timeout
+            limit = request.get_timeout().remaining();
+            if (!limit && session_.transfer_timeout_ > 0.0) {
+                limit = std::chrono::ceil<std::chrono::milliseconds>(std::chrono::duration<double>(session_.transfer_timeout_));
+            }
+            curl_easy_setopt(job->handle.get(), CURLOPT_TIMEOUT_MS, 0L);
+        }
+    } catch (const std::bad_alloc& e) {
+        // The event loop must keep running
+        failed = Error{CURLE_OUT_OF_MEMORY, Error::Phase::Setup};
+        job->detail = e.what();
+    } catch (const std::exception& e) {
+        failed = Error{CURLE_FAILED_INIT, Error::Phase::Setup};
+        job->detail = e.what();
+    }
+    if (failed) {
+        std::string detail = std::move(job->detail);
+        fail(std::move(job), *failed, std::move(detail));
+        return;
+    }
+
+    const uint64_t id = next_id_++;
+    job->id = id;
+    Job& started = *job;
+    jobs_.emplace(id, std::move(job));
+
+    curl_easy_setopt(started.handle.get(), CURLOPT_PRIVATE, &started);
+    if (curl_multi_add_handle(multi_handle_.get(), started.handle.get()) != CURLM_OK) {
+        started.detail = "Failed to add the transfer to the event loop";
+        finish(started, std::unexpected(Error{CURLE_FAILED_INIT, Error::Phase::Setup}));
+        release(started);
+        return;
+    }
+    if (limit) {
+        started.deadline = wheel_.schedule_after(*limit, [this, id] {
+            const auto it = jobs_.find(id);
+            if (it != jobs_.end()) {
+                it->second->deadline = {};
+                complete(*it->second, CURLE_OPERATION_TIMEDOUT);
+            }
+        });
+    }
+    if (started.request.get_stop_token().stop_possible()) {
+        started.cancel.emplace(started.request.get_stop_token(), CancelRequest{this, id});
+    }
+}
+
+template<typename Policy>
+void BasicAsyncSession<Policy>::collect_completions() {
+    int queued = 0;
+    while (CURLMsg* message = curl_multi_info_read(multi_handle_.get(), &queued)) {
+        if (message->msg != CURLMSG_DONE) {
+            continue;
+        }
+        const CURLcode result = message->data.result;
+        char* job = nullptr;
+        curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, &job);
+        complete(*reinterpret_cast<Job*>(job), result);
+    }
+}
+
+// Done, timed out or cancelled: detach from libcurl and deliver the result
+template<typename Policy>
+void BasicAsyncSession<Policy>::complete(Job& job, CURLcode result) {
+    wheel_.cancel(job.deadline);
+    curl_multi_remove_handle(multi_handle_.get(), job.handle.get());
+    std::expected<RESPONSE, Error> response = session_.finish_transfer(*job.transfer, result, &job.detail);
+    session_type::deliver_debug_trace(*job.transfer);
+    finish(job, std::move(response), job.transfer.get());
+    release(job);
+}
+
+// For requests that never reached libcurl
+template<typename Policy>
+void BasicAsyncSession<Policy>::fail(std::unique_ptr<Job> job, Error error, std::string detail) {
+    job->detail = std::move(detail);
+    finish(*job, std::unexpected(error));
+    if (job->handle) {
+        idle_handles_.push_back(std::move(job->handle));
+    }
+    in_flight_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+// `transfer` once the request ran, for the session's byte and connection counts
+template<typename Policy>
+void BasicAsyncSession<Policy>::finish(Job& job, std::expected<RESPONSE, Error>&& result, const typename session_type::Transfer* transfer) {
+    job.cancel.reset(); // Waits for a stop callback running on another thread
+    if constexpr (Policy::collect_statistics) {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - job.start_time);
+        session_.update_statistics(job.request, transfer, result ? CURLE_OK : result.error().code,
+                                   result ? result->statusCode : 0, elapsed);
+    }
+    try {
+        job.done(std::move(result), job.detail);
+    } catch (...) {
+        // A throwing completion must not take down the loop
+    }
+}
+
+template<typename Policy>
+void BasicAsyncSession<Policy>::release(Job& job) {
+    EasyHandle handle = std::move(job.handle);
+    jobs_.erase(job.id); // Destroys the transfer before its handle is reused
+    idle_handles_.push_back(std::move(handle));
+    in_flight_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+template<typename Policy>
+void BasicAsyncSession<Policy>::CurlMultiDeleter::operator()(CURLM* multi) const noexcept {
+    if (multi) {
+        curl_multi_cleanup(multi);
+    }
+}
+
+template<typename Policy>
+void BasicAsyncSession<Policy>::CurlHandleDeleter::operator()(CURL* handle) const noexcept {
+    if (handle) {
+        curl_easy_cleanup(handle);
+    }
+}
+
+template class BasicAsyncSession<DefaultPolicy>;
+template class BasicAsyncSession<TrustedPolicy>;
+
+} // namespace CurlX
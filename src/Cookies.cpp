@@ -3,23 +3,28 @@
 namespace CurlX {
 
     void COOKIES::add(std::string_view key, std::string_view value) {
-        cookies_[std::string(key)] = std::string(value);
+        StringType& slot = cookies_[StringType(key, cookies_.get_allocator())];
+        slot.assign(value);
     }
 
     void COOKIES::remove(std::string_view cookie_name) {
-        cookies_.erase(std::string(cookie_name));
+        cookies_.erase(StringType(cookie_name, cookies_.get_allocator()));
     }
 
     std::optional<std::string> COOKIES::get(std::string_view cookie_name) const {
-        auto it = cookies_.find(std::string(cookie_name));
+        auto it = cookies_.find(StringType(cookie_name, cookies_.get_allocator()));
         if (it != cookies_.end()) {
-            return it->second;
+            return std::string(it->second);
         }
         return std::nullopt;
     }
 
-    const std::unordered_map<std::string, std::string>& COOKIES::all() const noexcept {
+    const COOKIES::Storage& COOKIES::all() const noexcept {
         return cookies_;
     }
 
+    std::pmr::memory_resource* COOKIES::resource() const noexcept {
+        return cookies_.get_allocator().resource();
+    }
+
 } // namespace CurlX
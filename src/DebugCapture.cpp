@@ -0,0 +1,230 @@
+#include "CurlX/DebugCapture.hpp"
+#include <algorithm>
+#include <cctype>
+
+namespace CurlX {
+
+namespace {
+    constexpr std::string_view REDACTED = "[redacted]";
+
+    bool is_secret_header(std::string_view line) noexcept {
+        for (const std::string_view name : {"authorization", "proxy-authorization", "cookie", "set-cookie"}) {
+            if (line.size() > name.size() && line[name.size()] == ':' &&
+                std::equal(name.begin(), name.end(), line.begin(), [](char a, char b) {
+                    return a == std::tolower(static_cast<unsigned char>(b));
+                })) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // "https://user:pw@host/path?key=secret#top" -> "https://[redacted]@host/path?[redacted]#top".
+    // Also takes a request target without scheme and authority.
+    template<typename String>
+    void append_redacted_url(String& out, std::string_view url) {
+        if (const size_t scheme = url.find("://"); scheme != std::string_view::npos) {
+            const size_t start = scheme + 3;
+            const size_t end = std::min(url.find_first_of("/?#", start), url.size());
+            std::string_view authority = url.substr(start, end - start);
+            out.append(url.substr(0, start));
+            if (const size_t at = authority.rfind('@'); at != std::string_view::npos) {
+                out.append(REDACTED);
+                authority.remove_prefix(at);
+            }
+            out.append(authority);
+            url.remove_prefix(end);
+        }
+        const size_t query = url.find('?');
+        if (query == std::string_view::npos) {
+            out.append(url);
+            return;
+        }
+        const size_t fragment = std::min(url.find('#', query), url.size());
+        out.append(url.substr(0, query + 1));
+        if (fragment > query + 1) {
+            out.append(REDACTED);
+        }
+        out.append(url.substr(fragment));
+    }
+
+    // Every "scheme://..." token in a line of text
+    template<typename String>
+    void append_redacted_urls(String& out, std::string_view line) {
+        constexpr std::string_view DELIMITERS = " \t'\"<>";
+        for (size_t scheme = line.find("://"); scheme != std::string_view::npos; scheme = line.find("://")) {
+            const size_t before = line.find_last_of(DELIMITERS, scheme);
+            const size_t start = before == std::string_view::npos ? 0 : before + 1;
+            const size_t end = std::min(line.find_first_of(DELIMITERS, scheme), line.size());
+            out.append(line.substr(0, start));
+            append_redacted_url(out, line.substr(start, end - start));
+            line.remove_prefix(end);
+        }
+        out.append(line);
+    }
+
+    template<typename String>
+    void append_redacted(String& out, curl_infotype type, std::string_view text) {
+        for (bool first = true;; first = false) {
+            const size_t end = text.find('\n');
+            const std::string_view line = text.substr(0, end);
+            const size_t target = line.find(' ');
+            const size_t version = line.rfind(' ');
+            if (first && type == CURLINFO_HEADER_OUT && target != std::string_view::npos && version > target) {
+                // Request line: "GET /path?query HTTP/1.1"
+                out.append(line.substr(0, target + 1));
+                append_redacted_url(out, line.substr(target + 1, version - target - 1));
+                out.append(line.substr(version));
+            } else if (type != CURLINFO_TEXT && is_secret_header(line)) {
+                out.append(line.substr(0, line.find(':') + 1));
+                out.append(" ");
+                out.append(REDACTED);
+                if (line.back() == '\r') {
+                    out.append("\r");
+                }
+            } else {
+                append_redacted_urls(out, line);
+            }
+            if (end == std::string_view::npos) {
+                return;
+            }
+            out.append("\n");
+            text.remove_prefix(end + 1);
+        }
+    }
+}
+
+std::string DebugTrace::to_string() const {
+    std::string out;
+    out.reserve(128 + events.size() * 96);
+    out.append(method).append(" ").append(url).append(" -> ");
+    if (result != CURLE_OK) {
+        out.append(curl_easy_strerror(result));
+    } else {
+        out.append(std::to_string(status));
+    }
+    out.append(" in ").append(std::to_string(total.count())).append("us\n");
+    if (dropped) {
+        out.append("(").append(std::to_string(dropped)).append(" earlier events dropped)\n");
+    }
+
+    for (const Event& event : events) {
+        const char* marker = event.type == CURLINFO_HEADER_OUT ? "> " : event.type == CURLINFO_HEADER_IN ? "< " : "* ";
+        const std::string stamp = "[+" + std::to_string(event.at.count()) + "us] ";
+        // Sent headers arrive as one block; prefix each line
+        std::string_view text = event.text;
+        while (true) {
+            const size_t end = text.find('\n');
+            std::string_view line = text.substr(0, end);
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            out.append(stamp).append(marker).append(line).append("\n");
+            if (end == std::string_view::npos) {
+                break;
+            }
+            text.remove_prefix(end + 1);
+        }
+        if (event.truncated) {
+            out.append(stamp).append(marker).append("...\n");
+        }
+    }
+    return out;
+}
+
+DebugRecorder::DebugRecorder(std::shared_ptr<const DEBUG_CAPTURE> options, std::pmr::memory_resource* resource)
+    : options_(std::move(options)), start_(std::chrono::steady_clock::now()), slots_(resource) {
+    slots_.reserve(options_->max_events);
+}
+
+int DebugRecorder::callback(CURL*, curl_infotype type, char* data, size_t size, void* recorder) noexcept {
+    // Bodies and raw TLS records would crowd out the events worth keeping
+    if (type != CURLINFO_TEXT && type != CURLINFO_HEADER_IN && type != CURLINFO_HEADER_OUT) {
+        return 0;
+    }
+    try {
+        static_cast<DebugRecorder*>(recorder)->record(type, std::string_view(data, size));
+    } catch (...) {
+        // Out of memory: the event is lost, the transfer goes on
+    }
+    return 0;
+}
+
+void DebugRecorder::record(curl_infotype type, std::string_view text) {
+    const size_t capacity = options_->max_events;
+    if (capacity == 0) {
+        return;
+    }
+    while (!text.empty() && (text.back() == '\n' || text.back() == '\r')) {
+        text.remove_suffix(1);
+    }
+    const auto at = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_);
+
+    Slot* slot;
+    if (slots_.size() < capacity) {
+        slot = &slots_.emplace_back(type, at);
+    } else {
+        slot = &slots_[recorded_ % capacity];
+        slot->type = type;
+        slot->at = at;
+    }
+    slot->text.clear();
+    if (options_->redact_secrets) {
+        append_redacted(slot->text, type, text);
+    } else {
+        slot->text.append(text);
+    }
+    slot->truncated = slot->text.size() > options_->max_event_bytes;
+    if (slot->truncated) {
+        slot->text.resize(options_->max_event_bytes);
+    }
+    ++recorded_;
+}
+
+bool DebugRecorder::keeps(CURLcode result, long status, std::chrono::microseconds total) const noexcept {
+    if (options_->keep_failures && (result != CURLE_OK || status >= 500)) {
+        return true;
+    }
+    return total >= options_->slower_than;
+}
+
+PendingTrace DebugRecorder::finish(std::string_view method, std::string_view url, CURLcode result,
+                                   long status, std::chrono::microseconds total) const {
+    if (!keeps(result, status, total)) {
+        return {};
+    }
+
+    auto trace = std::make_shared<DebugTrace>();
+    trace->method = method;
+    if (options_->redact_secrets) {
+        append_redacted_url(trace->url, url);
+    } else {
+        trace->url = url;
+    }
+    trace->result = result;
+    trace->status = status;
+    trace->total = total;
+    trace->dropped = recorded_ - slots_.size();
+    trace->events.reserve(slots_.size());
+    // Once the ring has wrapped, the oldest event is the next one to be overwritten
+    const size_t first = slots_.size() < options_->max_events ? 0 : recorded_ % slots_.size();
+    for (size_t i = 0; i < slots_.size(); ++i) {
+        const Slot& slot = slots_[(first + i) % slots_.size()];
+        trace->events.push_back({slot.type, slot.at, std::string(slot.text), slot.truncated});
+    }
+
+    return PendingTrace{options_, std::move(trace)};
+}
+
+void PendingTrace::deliver() noexcept {
+    if (trace && options && options->sink) {
+        try {
+            options->sink(*trace);
+        } catch (...) {
+            // A failing sink must not fail the request
+        }
+    }
+    options.reset();
+}
+
+} // namespace CurlX
@@ -0,0 +1,88 @@
+#include "CurlX/Encoding.hpp"
+#include <array>
+#include <cstring>
+
+namespace CurlX {
+
+namespace {
+    // Output width of every byte: 1 if it passes through, 3 if it becomes %XX
+    struct EncodeTable {
+        std::array<unsigned char, 256> width{};
+    };
+
+    constexpr bool is_alnum(unsigned c) noexcept {
+        return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+    }
+
+    constexpr EncodeTable make_table(EncodeMode mode) noexcept {
+        EncodeTable table;
+        for (unsigned c = 0; c < 256; ++c) {
+            bool safe = is_alnum(c) || c == '-' || c == '_' || c == '.';
+            if (mode == EncodeMode::Query) {
+                safe = safe || c == '~';
+            } else {
+                safe = safe || c == '*' || c == ' '; // Space is written as '+'
+            }
+            table.width[c] = safe ? 1 : 3;
+        }
+        return table;
+    }
+
+    constexpr EncodeTable QUERY_TABLE = make_table(EncodeMode::Query);
+    constexpr EncodeTable FORM_TABLE = make_table(EncodeMode::Form);
+    constexpr char HEX_DIGITS[] = "0123456789ABCDEF";
+
+    constexpr const EncodeTable& table_for(EncodeMode mode) noexcept {
+        return mode == EncodeMode::Query ? QUERY_TABLE : FORM_TABLE;
+    }
+}
+
+size_t PercentEncoder::encoded_size(std::string_view value, EncodeMode mode) noexcept {
+    const auto& width = table_for(mode).width;
+    size_t size = 0;
+    for (unsigned char c : value) {
+        size += width[c];
+    }
+    return size;
+}
+
+char* PercentEncoder::write(std::string_view value, char* out, EncodeMode mode) noexcept {
+    const auto& width = table_for(mode).width;
+    const auto* in = reinterpret_cast<const unsigned char*>(value.data());
+    const auto* const end = in + value.size();
+
+    while (in < end) {
+        // Copy the run of bytes that need no escaping in one go
+        const auto* run = in;
+        while (run < end && width[*run] == 1) {
+            ++run;
+        }
+        if (run > in) {
+            const size_t length = static_cast<size_t>(run - in);
+            std::memcpy(out, in, length);
+            if (mode == EncodeMode::Form) {
+                for (size_t i = 0; i < length; ++i) {
+                    if (out[i] == ' ') out[i] = '+';
+                }
+            }
+            out += length;
+            in = run;
+        }
+        if (in < end) {
+            const unsigned char c = *in++;
+            out[0] = '%';
+            out[1] = HEX_DIGITS[c >> 4];
+            out[2] = HEX_DIGITS[c & 0x0F];
+            out += 3;
+        }
+    }
+    return out;
+}
+
+std::string PercentEncoder::encode(std::string_view value, EncodeMode mode) {
+    std::string result;
+    append(result, value, mode);
+    return result;
+}
+
+} // namespace CurlX
@@ -0,0 +1,49 @@
+#include "CurlX/Error.hpp"
+#include "CurlX/Exceptions.hpp"
+#include <string>
+
+namespace CurlX {
+
+std::string_view Error::message() const noexcept {
+    if (code != CURLE_OK) {
+        return curl_easy_strerror(code);
+    }
+    return phase == Phase::Parse ? "Response body is not valid JSON" : "Request failed";
+}
+
+std::string_view Error::phase_name() const noexcept {
+    switch (phase) {
+        case Phase::Setup: return "setup";
+        case Phase::Resolve: return "resolve";
+        case Phase::Connect: return "connect";
+        case Phase::Transfer: return "transfer";
+        case Phase::Body: return "body";
+        case Phase::Parse: return "parse";
+    }
+    return "unknown";
+}
+
+void Error::raise(std::string_view detail) const {
+    const std::string text(detail.empty() ? message() : detail);
+    if (phase == Phase::Body) {
+        throw RequestException(text);
+    }
+    if (phase == Phase::Parse) {
+        throw RequestException("Failed to parse JSON response: " + text);
+    }
+    switch (code) {
+        case CURLE_COULDNT_CONNECT:
+        case CURLE_COULDNT_RESOLVE_HOST:
+            throw ConnectionError(text);
+        case CURLE_OPERATION_TIMEDOUT:
+            throw Timeout(text);
+        case CURLE_TOO_MANY_REDIRECTS:
+            throw TooManyRedirects(text);
+        case CURLE_ABORTED_BY_CALLBACK:
+            throw Cancelled(text);
+        default:
+            throw RequestException(text);
+    }
+}
+
+} // namespace CurlX
@@ -22,6 +22,11 @@ namespace CurlX {
         request.timeout(timeout);
     }
 
+    template<>
+    void apply_option<std::stop_token>(REQUEST& request, const std::stop_token& token) {
+        request.cancel_on(token);
+    }
+
     template<>
     void apply_option<AUTH>(REQUEST& request, const AUTH& auth) {
         request.auth(auth);
@@ -57,4 +62,9 @@ namespace CurlX {
         request.files(files);
     }
 
+    template<>
+    void apply_option<LIMITS>(REQUEST& request, const LIMITS& limits) {
+        request.limits(limits);
+    }
+
 } // namespace CurlX
@@ -1,4 +1,5 @@
 #include "CurlX/Headers.hpp"
+#include "CurlX/Runtime.hpp"
 #include <curl/curl.h>
 #include <algorithm>
 #include <string>
@@ -46,16 +47,8 @@ namespace {
         return true;
     }
     
-    // Safe string concatenation with bounds checking
-    std::string safe_concat(std::string_view a, std::string_view b, std::string_view separator = ": ") {
-        if (a.length() + b.length() + separator.length() > MAX_HEADER_SIZE) {
-            throw std::length_error("Header size exceeds maximum allowed size");
-        }
-        return std::string(a) + std::string(separator) + std::string(b);
-    }
-    
     // Safe string search with bounds checking
-    size_t safe_find(const std::string& str, const std::string& search, size_t pos = 0) noexcept {
+    size_t safe_find(std::string_view str, std::string_view search, size_t pos = 0) noexcept {
         if (pos >= str.length()) return std::string::npos;
         if (search.empty()) return pos;
         if (search.length() > str.length() - pos) return std::string::npos;
@@ -64,12 +57,12 @@ namespace {
     }
     
     // Safe substring with bounds checking
-    std::string safe_substr(const std::string& str, size_t pos, size_t len = std::string::npos) noexcept {
+    std::string safe_substr(std::string_view str, size_t pos, size_t len = std::string::npos) noexcept {
         if (pos >= str.length()) return {};
         if (len == std::string::npos || pos + len > str.length()) {
             len = str.length() - pos;
         }
-        return str.substr(pos, len);
+        return std::string(str.substr(pos, len));
     }
 }
 
@@ -81,8 +74,13 @@ HEADERS::HEADERS(size_t initial_capacity) {
     headers_.reserve(initial_capacity);
 }
 
+HEADERS::HEADERS(std::pmr::memory_resource* resource) : headers_(resource) {}
+
 HEADERS::HEADERS(const HEADERS& other) : headers_(other.headers_) {}
 
+HEADERS::HEADERS(const HEADERS& other, std::pmr::memory_resource* resource)
+    : headers_(other.headers_, resource) {}
+
 HEADERS::HEADERS(HEADERS&& other) noexcept : headers_(std::move(other.headers_)) {}
 
 HEADERS& HEADERS::operator=(const HEADERS& other) {
@@ -114,9 +112,15 @@ void HEADERS::add(std::string_view key, std::string_view value) {
         throw std::length_error("Maximum number of headers exceeded");
     }
     
+    if (key.length() + value.length() + 2 > MAX_HEADER_SIZE) {
+        throw std::length_error("Header size exceeds maximum allowed size");
+    }
+    
     try {
-        std::string header = safe_concat(key, value);
-        headers_.push_back(std::move(header));
+        // Built in place so the line lives in this container's memory resource
+        StringType& header = headers_.emplace_back();
+        header.reserve(key.length() + value.length() + 2);
+        header.append(key).append(": ").append(value);
     } catch (const std::exception& e) {
         throw std::runtime_error("Failed to add header: " + std::string(e.what()));
     }
@@ -158,6 +162,10 @@ void HEADERS::add(std::string_view header_line) {
     }
 }
 
+void HEADERS::add_unchecked(std::string_view header_line) {
+    headers_.emplace_back(header_line);
+}
+
 void HEADERS::remove(std::string_view header_name) {
     if (header_name.empty() || !is_valid_header_name(header_name)) {
         return; // Silently ignore invalid header names
@@ -166,11 +174,11 @@ void HEADERS::remove(std::string_view header_name) {
     try {
         headers_.erase(
             std::remove_if(headers_.begin(), headers_.end(),
-                [&header_name](const std::string& header) {
+                [&header_name](const StringType& header) {
                     // Case-insensitive comparison with bounds checking
                     if (header.length() < header_name.length()) return false;
                     
-                    std::string header_lower = header;
+                    std::string header_lower(header);
                     std::string name_lower = std::string(header_name);
                     
                     // Convert to lowercase for comparison
@@ -196,7 +204,7 @@ std::optional<std::string> HEADERS::get(std::string_view header_name) const {
             if (header.length() < header_name.length()) continue;
             
             // Case-insensitive comparison
-            std::string header_lower = header;
+            std::string header_lower(header);
             std::string name_lower = std::string(header_name);
             
             std::transform(header_lower.begin(), header_lower.end(), header_lower.begin(), ::tolower);
@@ -216,11 +224,18 @@ std::optional<std::string> HEADERS::get(std::string_view header_name) const {
     return std::nullopt;
 }
 
-const std::vector<std::string>& HEADERS::all() const noexcept {
+const HEADERS::Storage& HEADERS::all() const noexcept {
     return headers_;
 }
 
+std::pmr::memory_resource* HEADERS::resource() const noexcept {
+    return headers_.get_allocator().resource();
+}
+
 struct curl_slist* HEADERS::to_curl_slist() const {
+    // The list is freed by libcurl, so it must come from libcurl's allocator
+    Runtime::ensure_initialized();
+    
     struct curl_slist* list = nullptr;
     
     try {
@@ -280,11 +295,11 @@ void HEADERS::reserve(size_t capacity) {
 }
 
 // Safe iteration with bounds checking
-std::vector<std::string>::const_iterator HEADERS::begin() const noexcept {
+HEADERS::Storage::const_iterator HEADERS::begin() const noexcept {
     return headers_.begin();
 }
 
-std::vector<std::string>::const_iterator HEADERS::end() const noexcept {
+HEADERS::Storage::const_iterator HEADERS::end() const noexcept {
     return headers_.end();
 }
 
@@ -301,8 +316,9 @@ bool HEADERS::is_valid() const noexcept {
                 return false;
             }
             
-            std::string_view name = header.substr(0, colon_pos);
-            std::string_view value = header.substr(colon_pos + 1);
+            const std::string_view line(header);
+            std::string_view name = line.substr(0, colon_pos);
+            std::string_view value = line.substr(colon_pos + 1);
             
             if (!is_valid_header_name(name) || !is_valid_header_value(value)) {
                 return false;
@@ -344,7 +360,7 @@ bool HEADERS::has(std::string_view header_name) const noexcept {
         for (const auto& header : headers_) {
             if (header.length() < header_name.length()) continue;
             
-            std::string header_lower = header;
+            std::string header_lower(header);
             std::transform(header_lower.begin(), header_lower.end(), header_lower.begin(), ::tolower);
             
             if (header_lower.rfind(name_lower, 0) == 0) {
@@ -0,0 +1,304 @@
+#include "CurlX/LatencyHistogram.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+namespace CurlX {
+
+void LatencySnapshot::record(Duration latency) noexcept {
+    const uint64_t micros = latency.count() > 0 ? static_cast<uint64_t>(latency.count()) : 0;
+    ++buckets_[LatencyBuckets::index(micros)];
+    ++count_;
+    sum_ += micros;
+    max_ = std::max(max_, micros);
+}
+
+void LatencySnapshot::merge(const LatencySnapshot& other) noexcept {
+    for (size_t i = 0; i < LatencyBuckets::COUNT; ++i) {
+        buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    sum_ += other.sum_;
+    max_ = std::max(max_, other.max_);
+}
+
+LatencySnapshot::Duration LatencySnapshot::percentile(double q) const noexcept {
+    if (count_ == 0) {
+        return Duration(0);
+    }
+    q = std::clamp(q, 0.0, 1.0);
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(count_))));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < LatencyBuckets::COUNT; ++i) {
+        seen += buckets_[i];
+        if (seen >= rank) {
+            return Duration(static_cast<Duration::rep>(std::min(LatencyBuckets::highest(i), max_)));
+        }
+    }
+    return max();
+}
+
+uint64_t LatencySnapshot::count_at_or_below(Duration limit) const noexcept {
+    if (limit.count() < 0) {
+        return 0;
+    }
+    const uint64_t micros = static_cast<uint64_t>(limit.count());
+    uint64_t total = 0;
+    for (size_t i = 0; i < LatencyBuckets::COUNT && LatencyBuckets::highest(i) <= micros; ++i) {
+        total += buckets_[i];
+    }
+    return total;
+}
+
+void LatencyHistogram::add_to(LatencySnapshot& snapshot) const noexcept {
+    for (size_t i = 0; i < LatencyBuckets::COUNT; ++i) {
+        snapshot.buckets_[i] += buckets_[i].load(std::memory_order_relaxed);
+    }
+    snapshot.count_ += count_.load(std::memory_order_relaxed);
+    snapshot.sum_ += sum_.load(std::memory_order_relaxed);
+    snapshot.max_ = std::max(snapshot.max_, max_.load(std::memory_order_relaxed));
+}
+
+// One thread's histograms. Only the owning thread inserts or records; the
+// mutex keeps readers off the map while an insert may rehash it.
+struct LatencyStats::Shard {
+    std::mutex mutex;
+    std::unordered_map<Key, LatencyHistogram, KeyHash, KeyEqual> histograms;
+};
+
+struct LatencyStats::Registry {
+    explicit Registry(size_t max_hosts) : limit(max_hosts) {}
+
+    HostLimit limit;
+    std::mutex mutex;
+    std::vector<Shard*> live;
+    std::unordered_map<Key, LatencySnapshot, KeyHash, KeyEqual> retired; // From threads that have exited
+};
+
+// The shards a thread owns, one per LatencyStats it has recorded into. On
+// thread exit each is folded into its registry, if that still exists.
+struct LatencyStats::ThreadShards {
+    struct Entry {
+        Registry* registry;
+        std::weak_ptr<Registry> owner;
+        std::unique_ptr<Shard> shard;
+    };
+
+    std::vector<Entry> entries;
+
+    ~ThreadShards() {
+        for (Entry& entry : entries) {
+            retire(entry);
+        }
+    }
+
+    static void retire(Entry& entry) {
+        const auto registry = entry.owner.lock();
+        if (!registry) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(registry->mutex);
+        std::erase(registry->live, entry.shard.get());
+        for (const auto& [key, histogram] : entry.shard->histograms) {
+            histogram.add_to(registry->retired[key]);
+        }
+    }
+};
+
+size_t LatencyStats::KeyHash::operator()(const KeyView& key) const noexcept {
+    const std::hash<std::string_view> hash;
+    size_t seed = hash(key.host);
+    seed ^= hash(key.method) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    seed ^= hash(key.status) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    return seed;
+}
+
+LatencyStats::LatencyStats(size_t max_hosts) : registry_(std::make_shared<Registry>(max_hosts)) {}
+
+LatencyStats::~LatencyStats() = default;
+
+LatencyStats::ThreadShards& LatencyStats::thread_shards() {
+    thread_local ThreadShards shards;
+    return shards;
+}
+
+LatencyStats::Shard& LatencyStats::local_shard() {
+    ThreadShards& shards = thread_shards();
+    for (const auto& entry : shards.entries) {
+        // A new registry may reuse a dead one's address
+        if (entry.registry == registry_.get() && !entry.owner.expired()) {
+            return *entry.shard;
+        }
+    }
+
+    std::erase_if(shards.entries, [](const ThreadShards::Entry& entry) { return entry.owner.expired(); });
+    auto shard = std::make_unique<Shard>();
+    {
+        std::lock_guard<std::mutex> lock(registry_->mutex);
+        registry_->live.push_back(shard.get());
+    }
+    shards.entries.push_back({registry_.get(), registry_, std::move(shard)});
+    return *shards.entries.back().shard;
+}
+
+std::string_view LatencyStats::status_class(long status) noexcept {
+    switch (status / 100) {
+        case 1: return "1xx";
+        case 2: return "2xx";
+        case 3: return "3xx";
+        case 4: return "4xx";
+        case 5: return "5xx";
+        default: return status <= 0 ? "failed" : "other";
+    }
+}
+
+void LatencyStats::record(std::string_view host, std::string_view method, long status,
+                          std::chrono::microseconds latency) {
+    if (!registry_) {
+        return; // Moved from
+    }
+    Shard& shard = local_shard();
+    KeyView key{host, method, status_class(status)};
+    auto it = shard.histograms.find(key);
+    if (it == shard.histograms.end()) {
+        key.host = registry_->limit.admit(host);
+        it = shard.histograms.find(key);
+    }
+    if (it == shard.histograms.end()) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        it = shard.histograms.try_emplace(Key{std::string(key.host), std::string(method), key.status}).first;
+    }
+    it->second.record(latency);
+}
+
+std::vector<std::pair<LatencyStats::Key, LatencySnapshot>> LatencyStats::snapshot() const {
+    std::vector<std::pair<Key, LatencySnapshot>> result;
+    if (!registry_) {
+        return result;
+    }
+
+    std::unordered_map<Key, LatencySnapshot, KeyHash, KeyEqual> merged;
+    {
+        std::lock_guard<std::mutex> lock(registry_->mutex);
+        merged = registry_->retired;
+        for (Shard* shard : registry_->live) {
+            std::lock_guard<std::mutex> shard_lock(shard->mutex);
+            for (const auto& [key, histogram] : shard->histograms) {
+                histogram.add_to(merged[key]);
+            }
+        }
+    }
+
+    result.reserve(merged.size());
+    for (auto& [key, snapshot] : merged) {
+        result.emplace_back(key, std::move(snapshot));
+    }
+    std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    return result;
+}
+
+LatencySnapshot LatencyStats::total() const {
+    LatencySnapshot total;
+    for (const auto& [key, snapshot] : snapshot()) {
+        total.merge(snapshot);
+    }
+    return total;
+}
+
+namespace {
+    // Exact decimal, without the rounding noise of dividing a double
+    void append_seconds(std::string& out, uint64_t micros) {
+        out += std::to_string(micros / 1000000);
+        uint64_t fraction = micros % 1000000;
+        if (fraction == 0) {
+            return;
+        }
+        char digits[7] = "000000";
+        for (int i = 5; i >= 0; --i, fraction /= 10) {
+            digits[i] = static_cast<char>('0' + fraction % 10);
+        }
+        std::string_view text(digits, 6);
+        out += '.';
+        out += text.substr(0, text.find_last_not_of('0') + 1);
+    }
+
+    void append_label_value(std::string& out, std::string_view value) {
+        for (const char c : value) {
+            switch (c) {
+                case '\\': out += "\\\\"; break;
+                case '"': out += "\\\""; break;
+                case '\n': out += "\\n"; break;
+                default: out += c;
+            }
+        }
+    }
+
+    // Coarse buckets in microseconds for the exposed histogram
+    constexpr uint64_t EXPOSED_BUCKETS[] = {
+        500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000,
+        1000000, 2500000, 5000000, 10000000, 30000000, 60000000,
+    };
+
+    constexpr std::pair<double, std::string_view> EXPOSED_QUANTILES[] = {
+        {0.5, "0.5"}, {0.9, "0.9"}, {0.99, "0.99"}, {0.999, "0.999"},
+    };
+}
+
+std::string LatencyStats::prometheus(std::string_view name) const {
+    const auto entries = snapshot();
+    std::string out;
+    out.reserve(256 + entries.size() * 2048);
+
+    const auto labels = [&out](const Key& key) {
+        out += "host=\"";
+        append_label_value(out, key.host);
+        out += "\",method=\"";
+        append_label_value(out, key.method);
+        out += "\",status=\"";
+        out += key.status;
+        out += '"';
+    };
+
+    out.append("# HELP ").append(name).append(" Request latency by host, method and status class.\n");
+    out.append("# TYPE ").append(name).append(" histogram\n");
+    for (const auto& [key, snapshot] : entries) {
+        for (const uint64_t limit : EXPOSED_BUCKETS) {
+            out.append(name).append("_bucket{");
+            labels(key);
+            out += ",le=\"";
+            append_seconds(out, limit);
+            out.append("\"} ").append(std::to_string(snapshot.count_at_or_below(std::chrono::microseconds(limit)))).append("\n");
+        }
+        out.append(name).append("_bucket{");
+        labels(key);
+        out.append(",le=\"+Inf\"} ").append(std::to_string(snapshot.count())).append("\n");
+
+        out.append(name).append("_sum{");
+        labels(key);
+        out += "} ";
+        append_seconds(out, static_cast<uint64_t>(snapshot.sum().count()));
+        out += '\n';
+
+        out.append(name).append("_count{");
+        labels(key);
+        out.append("} ").append(std::to_string(snapshot.count())).append("\n");
+    }
+
+    const std::string quantiles = std::string(name) + "_quantile";
+    out.append("# HELP ").append(quantiles).append(" Request latency quantiles from the full-resolution histogram.\n");
+    out.append("# TYPE ").append(quantiles).append(" gauge\n");
+    for (const auto& [key, snapshot] : entries) {
+        for (const auto& [q, label] : EXPOSED_QUANTILES) {
+            out.append(quantiles).append("{");
+            labels(key);
+            out.append(",quantile=\"").append(label).append("\"} ");
+            append_seconds(out, static_cast<uint64_t>(snapshot.percentile(q).count()));
+            out += '\n';
+        }
+    }
+    return out;
+}
+
+} // namespace CurlX
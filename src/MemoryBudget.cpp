@@ -0,0 +1,181 @@
+#include "CurlX/MemoryBudget.hpp"
+#include <stdexcept>
+
+namespace CurlX {
+
+// MemoryBudget implementation
+MemoryBudget::MemoryBudget(size_t limit_bytes, Overflow policy, size_t small_body_allowance)
+    : limit_(limit_bytes)
+    , policy_(policy)
+    , small_body_allowance_(small_body_allowance) {
+    if (limit_ == 0) {
+        throw std::invalid_argument("MemoryBudget limit must be greater than zero");
+    }
+}
+
+bool MemoryBudget::try_reserve(size_t bytes) noexcept {
+    size_t current = used_.load(std::memory_order_relaxed);
+    do {
+        if (current + bytes > limit_) {
+            return false;
+        }
+    } while (!used_.compare_exchange_weak(current, current + bytes, std::memory_order_relaxed));
+
+    update_peak(current + bytes);
+    return true;
+}
+
+void MemoryBudget::reserve(size_t bytes) noexcept {
+    const size_t now = used_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    update_peak(now);
+}
+
+void MemoryBudget::release(size_t bytes) noexcept {
+    // seq_cst pairs with wait_for_capacity so a wakeup cannot be missed
+    used_.fetch_sub(bytes);
+
+    if (waiters_.load() > 0) {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        capacity_cv_.notify_all();
+    }
+}
+
+bool MemoryBudget::wait_for_capacity(std::chrono::milliseconds timeout) {
+    if (!exhausted()) {
+        return true;
+    }
+
+    delayed_requests_.fetch_add(1, std::memory_order_relaxed);
+    waiters_.fetch_add(1);
+
+    std::unique_lock<std::mutex> lock(wait_mutex_);
+    bool ready;
+    if (timeout == std::chrono::milliseconds::zero()) {
+        capacity_cv_.wait(lock, [this] { return !exhausted(); });
+        ready = true;
+    } else {
+        ready = capacity_cv_.wait_for(lock, timeout, [this] { return !exhausted(); });
+    }
+
+    waiters_.fetch_sub(1);
+    return ready;
+}
+
+bool MemoryBudget::wait_for_capacity(std::optional<std::chrono::milliseconds> timeout, const std::stop_token& token) {
+    if (!exhausted()) {
+        return true;
+    }
+    if (token.stop_requested() || (timeout && timeout->count() <= 0)) {
+        return false;
+    }
+
+    delayed_requests_.fetch_add(1, std::memory_order_relaxed);
+    waiters_.fetch_add(1);
+
+    // Registered before taking the lock: an already stopped token runs the callback here
+    std::stop_callback wake(token, [this] {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        capacity_cv_.notify_all();
+    });
+    const auto ready = [this, &token] { return token.stop_requested() || !exhausted(); };
+    bool woken;
+    {
+        std::unique_lock<std::mutex> lock(wait_mutex_);
+        if (timeout) {
+            woken = capacity_cv_.wait_for(lock, *timeout, ready);
+        } else {
+            capacity_cv_.wait(lock, ready);
+            woken = true;
+        }
+    }
+
+    waiters_.fetch_sub(1);
+    return woken && !token.stop_requested();
+}
+
+bool MemoryBudget::exhausted() const noexcept {
+    return used_.load() >= limit_;
+}
+
+void MemoryBudget::register_session() noexcept {
+    sessions_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MemoryBudget::unregister_session() noexcept {
+    sessions_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+size_t MemoryBudget::used() const noexcept {
+    return used_.load(std::memory_order_relaxed);
+}
+
+size_t MemoryBudget::peak() const noexcept {
+    return peak_.load(std::memory_order_relaxed);
+}
+
+size_t MemoryBudget::registered_sessions() const noexcept {
+    return sessions_.load(std::memory_order_relaxed);
+}
+
+size_t MemoryBudget::spilled_transfers() const noexcept {
+    return spilled_transfers_.load(std::memory_order_relaxed);
+}
+
+size_t MemoryBudget::delayed_requests() const noexcept {
+    return delayed_requests_.load(std::memory_order_relaxed);
+}
+
+void MemoryBudget::record_spill() noexcept {
+    spilled_transfers_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MemoryBudget::update_peak(size_t value) noexcept {
+    size_t peak = peak_.load(std::memory_order_relaxed);
+    while (value > peak && !peak_.compare_exchange_weak(peak, value, std::memory_order_relaxed)) {
+    }
+}
+
+// BudgetLease implementation
+BudgetLease::~BudgetLease() {
+    release();
+}
+
+BudgetLease::BudgetLease(BudgetLease&& other) noexcept
+    : budget_(std::move(other.budget_))
+    , bytes_(other.bytes_) {
+    other.bytes_ = 0;
+}
+
+BudgetLease& BudgetLease::operator=(BudgetLease&& other) noexcept {
+    if (this != &other) {
+        release();
+        budget_ = std::move(other.budget_);
+        bytes_ = other.bytes_;
+        other.bytes_ = 0;
+    }
+    return *this;
+}
+
+bool BudgetLease::try_grow(size_t bytes) noexcept {
+    if (!budget_) return true;
+    if (!budget_->try_reserve(bytes)) {
+        return false;
+    }
+    bytes_ += bytes;
+    return true;
+}
+
+void BudgetLease::grow(size_t bytes) noexcept {
+    if (!budget_) return;
+    budget_->reserve(bytes);
+    bytes_ += bytes;
+}
+
+void BudgetLease::release() noexcept {
+    if (budget_ && bytes_ > 0) {
+        budget_->release(bytes_);
+    }
+    bytes_ = 0;
+}
+
+} // namespace CurlX
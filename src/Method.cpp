@@ -1,11 +1,11 @@
 #include "CurlX/Method.hpp"
 
 namespace CurlX {
-    const METHOD METHOD::GET("GET");
-    const METHOD METHOD::POST("POST");
-    const METHOD METHOD::PUT("PUT");
-    const METHOD METHOD::DELETE("DELETE");
-    const METHOD METHOD::HEAD("HEAD");
-    const METHOD METHOD::OPTIONS("OPTIONS");
-    const METHOD METHOD::PATCH("PATCH");
+    const METHOD METHOD::GET(METHOD::Verb::GET);
+    const METHOD METHOD::POST(METHOD::Verb::POST);
+    const METHOD METHOD::PUT(METHOD::Verb::PUT);
+    const METHOD METHOD::DELETE(METHOD::Verb::DELETE);
+    const METHOD METHOD::HEAD(METHOD::Verb::HEAD);
+    const METHOD METHOD::OPTIONS(METHOD::Verb::OPTIONS);
+    const METHOD METHOD::PATCH(METHOD::Verb::PATCH);
 }
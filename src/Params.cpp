@@ -0,0 +1,136 @@
+#include "CurlX/Params.hpp"
+#include <limits>
+#include <stdexcept>
+
+namespace CurlX {
+
+namespace {
+    void check_length(size_t length) {
+        if (length > std::numeric_limits<uint32_t>::max()) {
+            throw std::length_error("Parameter key or value is too long");
+        }
+    }
+}
+
+PARAMS::PARAMS(const StringMap& p) {
+    size_t bytes = 0;
+    for (const auto& [key, value] : p) {
+        bytes += key.size() + value.size() + 2;
+    }
+    reserve(p.size(), bytes);
+    for (const auto& [key, value] : p) {
+        add(key, value);
+    }
+}
+
+PARAMS::PARAMS(std::initializer_list<std::pair<std::string_view, std::string_view>> init_list) {
+    size_t bytes = 0;
+    for (const auto& [key, value] : init_list) {
+        bytes += key.size() + value.size() + 2;
+    }
+    reserve(init_list.size(), bytes);
+    for (const auto& [key, value] : init_list) {
+        add(key, value);
+    }
+}
+
+size_t PARAMS::append_key(std::string_view key) {
+    check_length(key.size());
+    buffer_.append(key);
+    buffer_.push_back('\0');
+    return buffer_.size();
+}
+
+void PARAMS::finish_entry(size_t value_offset, size_t key_size, size_t value_size) {
+    check_length(value_size);
+    entries_.push_back(Entry{value_offset - key_size - 1, static_cast<uint32_t>(key_size), static_cast<uint32_t>(value_size)});
+}
+
+PARAMS& PARAMS::add(std::string_view key, std::string_view value) {
+    check_length(value.size());
+    const size_t value_offset = append_key(key);
+    buffer_.append(value);
+    buffer_.push_back('\0');
+    finish_entry(value_offset, key.size(), value.size());
+    return *this;
+}
+
+PARAMS& PARAMS::set(std::string_view key, std::string_view value) {
+    remove(key);
+    return add(key, value);
+}
+
+size_t PARAMS::remove(std::string_view key) {
+    const size_t matches = count(key);
+    if (matches == 0) {
+        return 0;
+    }
+
+    // Rebuild without the removed pairs so the buffer stays compact
+    PARAMS kept(resource());
+    kept.reserve(entries_.size() - matches, buffer_.size());
+    for (const Param param : *this) {
+        if (param.key != key) {
+            kept.add(param.key, param.value);
+        }
+    }
+    buffer_.swap(kept.buffer_);
+    entries_.swap(kept.entries_);
+    return matches;
+}
+
+std::optional<std::string_view> PARAMS::get(std::string_view key) const {
+    for (const Param param : *this) {
+        if (param.key == key) {
+            return param.value;
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<std::string_view> PARAMS::get_all(std::string_view key) const {
+    std::vector<std::string_view> values;
+    for (const Param param : *this) {
+        if (param.key == key) {
+            values.push_back(param.value);
+        }
+    }
+    return values;
+}
+
+size_t PARAMS::count(std::string_view key) const {
+    size_t matches = 0;
+    for (const Param param : *this) {
+        if (param.key == key) {
+            ++matches;
+        }
+    }
+    return matches;
+}
+
+PARAMS::Param PARAMS::operator[](size_t index) const {
+    const Entry& entry = entries_[index];
+    const char* key = buffer_.data() + entry.key_offset;
+    return Param{std::string_view(key, entry.key_size),
+                 std::string_view(key + entry.key_size + 1, entry.value_size)};
+}
+
+void PARAMS::reserve(size_t pairs, size_t bytes) {
+    entries_.reserve(pairs);
+    buffer_.reserve(bytes);
+}
+
+void PARAMS::clear() noexcept {
+    buffer_.clear();
+    entries_.clear();
+}
+
+StringMap PARAMS::get() const {
+    StringMap result;
+    for (const Param param : *this) {
+        result.insert_or_assign(std::string(param.key), std::string(param.value));
+    }
+    return result;
+}
+
+} // namespace CurlX
@@ -0,0 +1,158 @@
+#include "CurlX/ParsedUrl.hpp"
+#include "CurlX/Url.hpp"
+#include "CurlX/Runtime.hpp"
+#include "CurlX/Exceptions.hpp"
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <cstdlib>
+#include <limits>
+
+namespace CurlX {
+
+namespace {
+    // Owns a string returned by curl_url_get
+    struct CurlString {
+        char* value{nullptr};
+        ~CurlString() { curl_free(value); }
+    };
+
+    [[noreturn]] void throw_url_error(std::string_view url, CURLUcode code) {
+        throw RequestException("Invalid URL '" + std::string(url) + "': " + curl_url_strerror(code));
+    }
+}
+
+// ParsedURL implementation
+ParsedURL::ParsedURL(std::string_view url) {
+    auto parsed = parse(url);
+    if (!parsed) {
+        if (parsed.error() == CURLUE_OUT_OF_MEMORY) {
+            throw RequestException("Failed to allocate URL handle");
+        }
+        throw_url_error(url, parsed.error());
+    }
+    *this = std::move(*parsed);
+}
+
+std::expected<ParsedURL, CURLUcode> ParsedURL::parse(std::string_view url) {
+    // CURLU memory comes from libcurl's allocator
+    Runtime::ensure_initialized();
+
+    ParsedURL parsed;
+    parsed.handle_.reset(curl_url());
+    if (!parsed.handle_) {
+        return std::unexpected(CURLUE_OUT_OF_MEMORY);
+    }
+
+    const std::string input(url); // curl_url_set needs a NUL-terminated string
+    // Leave unsupported schemes to the transfer, so they fail the same way they did with CURLOPT_URL
+    const CURLUcode code = curl_url_set(parsed.handle_.get(), CURLUPART_URL, input.c_str(),
+                                        CURLU_GUESS_SCHEME | CURLU_NON_SUPPORT_SCHEME);
+    if (code != CURLUE_OK) {
+        return std::unexpected(code);
+    }
+    parsed.init_parts(url.size());
+    return parsed;
+}
+
+void ParsedURL::init_parts(size_t url_size) {
+    buffer_.reserve(url_size * 2 + 16);
+    url_ = append_part(CURLUPART_URL);
+    scheme_ = append_part(CURLUPART_SCHEME);
+    host_ = append_part(CURLUPART_HOST);
+    path_ = append_part(CURLUPART_PATH);
+    query_ = append_part(CURLUPART_QUERY);
+    fragment_ = append_part(CURLUPART_FRAGMENT);
+
+    CurlString port;
+    explicit_port_ = curl_url_get(handle_.get(), CURLUPART_PORT, &port.value, 0) == CURLUE_OK;
+    if (!explicit_port_) {
+        curl_free(port.value);
+        port.value = nullptr;
+        curl_url_get(handle_.get(), CURLUPART_PORT, &port.value, CURLU_DEFAULT_PORT);
+    }
+    if (port.value) {
+        port_ = static_cast<uint16_t>(std::strtoul(port.value, nullptr, 10));
+    }
+
+    // Host key: lowercase scheme://host:port
+    std::string key;
+    key.reserve(scheme_.size + host_.size + 9);
+    key.append(scheme()).append("://").append(host()).append(":").append(std::to_string(port_));
+    std::transform(key.begin(), key.end(), key.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    host_key_ = append(key);
+    host_hash_ = std::hash<std::string_view>{}(host_key());
+}
+
+ParsedURL::ParsedURL(const ParsedURL& other)
+    : handle_(other.clone_handle())
+    , buffer_(other.buffer_)
+    , url_(other.url_)
+    , scheme_(other.scheme_)
+    , host_(other.host_)
+    , path_(other.path_)
+    , query_(other.query_)
+    , fragment_(other.fragment_)
+    , host_key_(other.host_key_)
+    , port_(other.port_)
+    , explicit_port_(other.explicit_port_)
+    , host_hash_(other.host_hash_) {}
+
+ParsedURL& ParsedURL::operator=(const ParsedURL& other) {
+    if (this != &other) {
+        ParsedURL copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+ParsedURL::Handle ParsedURL::clone_handle() const {
+    Handle copy(handle_ ? curl_url_dup(handle_.get()) : nullptr);
+    if (handle_ && !copy) {
+        throw RequestException("Failed to copy URL handle");
+    }
+    return copy;
+}
+
+ParsedURL::Span ParsedURL::append(std::string_view part) {
+    if (buffer_.size() + part.size() > std::numeric_limits<uint32_t>::max()) {
+        throw RequestException("URL is too long");
+    }
+    Span span{static_cast<uint32_t>(buffer_.size()), static_cast<uint32_t>(part.size())};
+    buffer_.append(part);
+    return span;
+}
+
+ParsedURL::Span ParsedURL::append_part(CURLUPart part, unsigned int flags) {
+    CurlString value;
+    if (curl_url_get(handle_.get(), part, &value.value, flags) != CURLUE_OK || !value.value) {
+        return Span{}; // Component not present
+    }
+    return append(value.value);
+}
+
+// URL implementation
+std::shared_ptr<const ParsedURL> URL::parsed() const {
+    auto cached = try_parsed();
+    if (!cached) {
+        throw_url_error(url_str, cached.error());
+    }
+    return std::move(*cached);
+}
+
+std::expected<std::shared_ptr<const ParsedURL>, CURLUcode> URL::try_parsed() const {
+    auto cached = parsed_.load(std::memory_order_acquire);
+    if (!cached) {
+        // Concurrent first calls may both parse; either result is equivalent
+        auto parsed = ParsedURL::parse(url_str);
+        if (!parsed) {
+            return std::unexpected(parsed.error());
+        }
+        cached = std::make_shared<const ParsedURL>(std::move(*parsed));
+        parsed_.store(cached, std::memory_order_release);
+    }
+    return cached;
+}
+
+} // namespace CurlX
@@ -1,7 +1,13 @@
 #include "CurlX/Response.hpp"
+#include <iostream>
 
 namespace CurlX {
 
+RESPONSE::RESPONSE(std::pmr::memory_resource* resource)
+    : headers(resource)
+    , request_headers(resource)
+    , received_cookies(resource) {}
+
 // Copy constructor
 RESPONSE::RESPONSE(const RESPONSE& other)
     : statusCode(other.statusCode)
@@ -14,6 +20,10 @@ RESPONSE::RESPONSE(const RESPONSE& other)
     , request_headers(other.request_headers)
     , received_cookies(other.received_cookies)
     , elapsed_time(other.elapsed_time)
+    , timings(other.timings)
+    , traffic(other.traffic)
+    , cpu_time(other.cpu_time)
+    , debug_trace(other.debug_trace)
     , history(other.history)
     , timestamp(other.timestamp)
     , content_length(other.content_length)
@@ -39,6 +49,10 @@ RESPONSE::RESPONSE(RESPONSE&& other) noexcept
     , request_headers(std::move(other.request_headers))
     , received_cookies(std::move(other.received_cookies))
     , elapsed_time(other.elapsed_time)
+    , timings(other.timings)
+    , traffic(other.traffic)
+    , cpu_time(other.cpu_time)
+    , debug_trace(std::move(other.debug_trace))
     , history(std::move(other.history))
     , timestamp(other.timestamp)
     , content_length(other.content_length)
@@ -56,6 +70,9 @@ RESPONSE::RESPONSE(RESPONSE&& other) noexcept
     other.statusCode = 0;
     other.is_redirect = false;
     other.elapsed_time = 0.0;
+    other.timings = TIMINGS();
+    other.traffic = TRAFFIC();
+    other.cpu_time = CPU_TIME();
     other.content_length = 0;
     other.is_compressed = false;
     other.content_type_detected_ = false;
@@ -75,6 +92,10 @@ RESPONSE& RESPONSE::operator=(const RESPONSE& other) {
         request_headers = other.request_headers;
         received_cookies = other.received_cookies;
         elapsed_time = other.elapsed_time;
+        timings = other.timings;
+        traffic = other.traffic;
+        cpu_time = other.cpu_time;
+        debug_trace = other.debug_trace;
         history = other.history;
         timestamp = other.timestamp;
         content_length = other.content_length;
@@ -104,6 +125,10 @@ RESPONSE& RESPONSE::operator=(RESPONSE&& other) noexcept {
         request_headers = std::move(other.request_headers);
         received_cookies = std::move(other.received_cookies);
         elapsed_time = other.elapsed_time;
+        timings = other.timings;
+        traffic = other.traffic;
+        cpu_time = other.cpu_time;
+        debug_trace = std::move(other.debug_trace);
         history = std::move(other.history);
         timestamp = other.timestamp;
         content_length = other.content_length;
@@ -121,6 +146,9 @@ RESPONSE& RESPONSE::operator=(RESPONSE&& other) noexcept {
         other.statusCode = 0;
         other.is_redirect = false;
         other.elapsed_time = 0.0;
+        other.timings = TIMINGS();
+        other.traffic = TRAFFIC();
+        other.cpu_time = CPU_TIME();
         other.content_length = 0;
         other.is_compressed = false;
         other.content_type_detected_ = false;
@@ -165,11 +193,46 @@ bool RESPONSE::is_success() const noexcept {
 
 // Basic content access methods
 std::string RESPONSE::text() const noexcept {
-    return body;
+    return body.str();
+}
+
+std::string_view RESPONSE::text_view() const {
+    return body.view();
+}
+
+// JSON parsing; needs contiguous memory, so a segmented body is flattened here
+nlohmann::json RESPONSE::json() const {
+    if (!cached_json_) {
+        try {
+            cached_json_ = std::make_shared<const nlohmann::json>(nlohmann::json::parse(text_view()));
+        } catch (const nlohmann::json::exception& e) {
+            throw RequestException(std::string("Failed to parse JSON response: ") + e.what());
+        }
+    }
+    return *cached_json_;
+}
+
+std::optional<nlohmann::json> RESPONSE::json_safe() const noexcept {
+    try {
+        auto parsed = try_json();
+        if (parsed) {
+            return std::move(*parsed);
+        }
+    } catch (...) {
+        // Allocation failure while copying the document
+    }
+    return std::nullopt;
 }
 
-std::string_view RESPONSE::text_view() const noexcept {
-    return body;
+std::expected<nlohmann::json, Error> RESPONSE::try_json() const {
+    if (!cached_json_) {
+        auto parsed = nlohmann::json::parse(text_view(), nullptr, false); // No exception on bad input
+        if (parsed.is_discarded()) {
+            return std::unexpected(Error{CURLE_OK, Error::Phase::Parse});
+        }
+        cached_json_ = std::make_shared<const nlohmann::json>(std::move(parsed));
+    }
+    return *cached_json_;
 }
 
 // Basic utility methods
@@ -193,4 +256,100 @@ double RESPONSE::get_response_time() const noexcept {
     return elapsed_time;
 }
 
+// Approximate heap footprint; a shared body is counted in full by every copy
+size_t RESPONSE::estimate_memory_usage() const noexcept {
+    size_t total = sizeof(RESPONSE);
+    if (!body.is_mapped()) {
+        total += body.size(); // Mapped bodies live in the page cache
+    }
+    for (const auto& header : headers.all()) {
+        total += sizeof(header) + header.capacity();
+    }
+    for (const auto& header : request_headers.all()) {
+        total += sizeof(header) + header.capacity();
+    }
+    for (const auto& [name, value] : received_cookies.all()) {
+        total += name.capacity() + value.capacity();
+    }
+    for (const auto& entry : history) {
+        total += sizeof(entry) + entry.toString().capacity();
+    }
+    total += reason.capacity() + content_type.capacity() + encoding.capacity() +
+             server_info.capacity() + last_modified.capacity() + etag.capacity() +
+             url.toString().capacity() + request_url.toString().capacity();
+    return total;
+}
+
+std::string RESPONSE::get_debug_info() const {
+    std::string out;
+    out.reserve(512);
+    const auto line = [&out](std::string_view label, std::string_view value) {
+        out.append(label).append(": ").append(value).append("\n");
+    };
+    const auto us = [](std::chrono::microseconds value) { return std::to_string(value.count()) + "us"; };
+
+    line("Status", reason.empty() ? std::to_string(statusCode) : std::to_string(statusCode) + " " + reason);
+    line("URL", url.toString());
+    if (request_url.toString() != url.toString()) {
+        line("Requested", request_url.toString());
+    }
+    if (!history.empty()) {
+        line("Redirects", std::to_string(history.size()));
+    }
+    line("Time", us(timings.total) + " (dns " + us(timings.dns()) + ", tcp " + us(timings.tcp()) + ", tls " +
+                     us(timings.tls()) + ", server " + us(timings.server()) + ", download " + us(timings.download()) + ")");
+    line("Connection", timings.reused_connection() ? "reused" : "new");
+    if (cpu_time.total().count() > 0) {
+        const auto cpu_us = [&us](std::chrono::nanoseconds value) {
+            return us(std::chrono::duration_cast<std::chrono::microseconds>(value));
+        };
+        line("CPU", cpu_us(cpu_time.total()) + " (setup " + cpu_us(cpu_time.setup) + ", callbacks " +
+                        cpu_us(cpu_time.callbacks) + ", post " + cpu_us(cpu_time.post) + ", libcurl " +
+                        cpu_us(cpu_time.libcurl) + ")");
+    }
+    line("Sent", std::to_string(traffic.sent()) + " bytes (" + std::to_string(traffic.request_headers) + " headers)");
+    line("Received", std::to_string(traffic.received()) + " bytes (" + std::to_string(traffic.response_headers) +
+                         " headers), body " + std::to_string(body.size()) + " bytes decoded");
+    if (!content_type.empty()) {
+        line("Content-Type", content_type);
+    }
+    out.append("Headers:\n");
+    for (const auto& header : headers.all()) {
+        out.append("  ").append(header).append("\n");
+    }
+    if (debug_trace) {
+        out.append("Debug trace:\n").append(debug_trace->to_string());
+    }
+    return out;
+}
+
+void RESPONSE::log_performance_metrics() const {
+    std::string out = "curlx status=" + std::to_string(statusCode);
+    out.append(" url=").append(url.toString());
+    out.append(" total_us=").append(std::to_string(timings.total.count()));
+    out.append(" dns_us=").append(std::to_string(timings.dns().count()));
+    out.append(" tcp_us=").append(std::to_string(timings.tcp().count()));
+    out.append(" tls_us=").append(std::to_string(timings.tls().count()));
+    out.append(" ttfb_us=").append(std::to_string(timings.start_transfer.count()));
+    out.append(" sent=").append(std::to_string(traffic.sent()));
+    out.append(" received=").append(std::to_string(traffic.received()));
+    out.append(" cpu_ns=").append(std::to_string(cpu_time.total().count()));
+    out.append(" reused=").append(timings.reused_connection() ? "1" : "0");
+    out += '\n';
+    std::clog << out; // One write, so concurrent lines do not interleave
+}
+
+namespace ResponseUtils {
+
+double calculate_response_efficiency(const RESPONSE& response) {
+    const uint64_t wire = response.traffic.wire();
+    return wire ? static_cast<double>(response.traffic.decoded_body) / static_cast<double>(wire) : 0.0;
+}
+
+size_t estimate_memory_footprint(const RESPONSE& response) {
+    return response.estimate_memory_usage();
+}
+
+} // namespace ResponseUtils
+
 } // namespace CurlX
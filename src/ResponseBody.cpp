@@ -0,0 +1,388 @@
+#include "CurlX/ResponseBody.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace CurlX {
+
+// BodyBlockPool implementation
+BodyBlockPool& BodyBlockPool::instance() {
+    static BodyBlockPool pool;
+    return pool;
+}
+
+std::unique_ptr<char[]> BodyBlockPool::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        if (!free_blocks_.empty()) {
+            auto block = std::move(free_blocks_.back());
+            free_blocks_.pop_back();
+            return block;
+        }
+    }
+    // Uninitialized on purpose: every byte is written before it is read
+    return std::unique_ptr<char[]>(new char[BLOCK_SIZE]);
+}
+
+void BodyBlockPool::release(std::unique_ptr<char[]> block) noexcept {
+    if (!block) return;
+
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    if (free_blocks_.size() < max_cached_blocks_) {
+        try {
+            free_blocks_.push_back(std::move(block));
+        } catch (...) {
+            // Block is freed by its unique_ptr
+        }
+    }
+}
+
+void BodyBlockPool::set_max_cached_blocks(size_t max_blocks) {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    max_cached_blocks_ = max_blocks;
+    if (free_blocks_.size() > max_cached_blocks_) {
+        free_blocks_.resize(max_cached_blocks_);
+    }
+}
+
+size_t BodyBlockPool::cached_blocks() const noexcept {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    return free_blocks_.size();
+}
+
+void BodyBlockPool::trim() noexcept {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    free_blocks_.clear();
+    free_blocks_.shrink_to_fit();
+}
+
+// SegmentedBuffer implementation
+SegmentedBuffer::~SegmentedBuffer() {
+    clear();
+}
+
+SegmentedBuffer::SegmentedBuffer(SegmentedBuffer&& other) noexcept
+    : blocks_(std::move(other.blocks_))
+    , size_(other.size_) {
+    other.blocks_.clear();
+    other.size_ = 0;
+}
+
+SegmentedBuffer& SegmentedBuffer::operator=(SegmentedBuffer&& other) noexcept {
+    if (this != &other) {
+        clear();
+        blocks_ = std::move(other.blocks_);
+        size_ = other.size_;
+        other.blocks_.clear();
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+void SegmentedBuffer::append(const char* data, size_t length) {
+    while (length > 0) {
+        if (blocks_.empty() || blocks_.back().used == BodyBlockPool::BLOCK_SIZE) {
+            blocks_.push_back(Block{BodyBlockPool::instance().acquire(), 0});
+        }
+
+        Block& block = blocks_.back();
+        const size_t chunk = std::min(length, BodyBlockPool::BLOCK_SIZE - block.used);
+        std::memcpy(block.data.get() + block.used, data, chunk);
+        block.used += chunk;
+        size_ += chunk;
+        data += chunk;
+        length -= chunk;
+    }
+}
+
+void SegmentedBuffer::clear() noexcept {
+    for (auto& block : blocks_) {
+        BodyBlockPool::instance().release(std::move(block.data));
+    }
+    blocks_.clear();
+    size_ = 0;
+}
+
+std::vector<std::span<const char>> SegmentedBuffer::spans() const {
+    std::vector<std::span<const char>> result;
+    result.reserve(blocks_.size());
+    for (const auto& block : blocks_) {
+        result.emplace_back(block.data.get(), block.used);
+    }
+    return result;
+}
+
+std::string SegmentedBuffer::flatten() const {
+    std::string result;
+    result.reserve(size_);
+    for (const auto& block : blocks_) {
+        result.append(block.data.get(), block.used);
+    }
+    return result;
+}
+
+// MappedFile implementation
+MappedFile::~MappedFile() {
+    if (address_) {
+        ::munmap(address_, size_);
+    }
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : address_(other.address_)
+    , size_(other.size_) {
+    other.address_ = nullptr;
+    other.size_ = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        if (address_) {
+            ::munmap(address_, size_);
+        }
+        address_ = other.address_;
+        size_ = other.size_;
+        other.address_ = nullptr;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+MappedFile MappedFile::map(int fd, size_t size) {
+    MappedFile mapping;
+    if (size == 0) {
+        return mapping;
+    }
+
+    void* address = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (address == MAP_FAILED) {
+        throw std::system_error(errno, std::generic_category(), "Failed to map spilled response body");
+    }
+    ::madvise(address, size, MADV_SEQUENTIAL);
+
+    mapping.address_ = address;
+    mapping.size_ = size;
+    return mapping;
+}
+
+std::string_view MappedFile::view() const noexcept {
+    return address_ ? std::string_view(static_cast<const char*>(address_), size_) : std::string_view();
+}
+
+// SpillFile implementation
+SpillFile::SpillFile(const std::string& directory) {
+    std::string dir = directory;
+    if (dir.empty()) {
+        const char* tmpdir = std::getenv("TMPDIR");
+        dir = (tmpdir && *tmpdir) ? tmpdir : "/tmp";
+    }
+
+    std::string path_template = dir + "/curlx-body-XXXXXX";
+    fd_ = ::mkostemp(path_template.data(), O_CLOEXEC);
+    if (fd_ < 0) {
+        throw std::system_error(errno, std::generic_category(), "Failed to create spill file in " + dir);
+    }
+    // Unlink right away so the file never outlives the process
+    ::unlink(path_template.c_str());
+}
+
+SpillFile::~SpillFile() {
+    close();
+}
+
+SpillFile::SpillFile(SpillFile&& other) noexcept
+    : fd_(other.fd_)
+    , size_(other.size_) {
+    other.fd_ = -1;
+    other.size_ = 0;
+}
+
+SpillFile& SpillFile::operator=(SpillFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        fd_ = other.fd_;
+        size_ = other.size_;
+        other.fd_ = -1;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+void SpillFile::write(const char* data, size_t length) {
+    if (fd_ < 0) {
+        throw std::logic_error("SpillFile is closed");
+    }
+
+    while (length > 0) {
+        const ssize_t written = ::write(fd_, data, length);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw std::system_error(errno, std::generic_category(), "Failed to write spill file");
+        }
+        data += written;
+        length -= static_cast<size_t>(written);
+        size_ += static_cast<size_t>(written);
+    }
+}
+
+MappedFile SpillFile::map() {
+    if (fd_ < 0) {
+        throw std::logic_error("SpillFile is closed");
+    }
+    MappedFile mapping = MappedFile::map(fd_, size_);
+    close(); // The mapping keeps the file contents alive
+    return mapping;
+}
+
+void SpillFile::close() noexcept {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+// ResponseBody implementation
+struct ResponseBody::Storage {
+    explicit Storage(std::string d) : data(std::move(d)), size(data.size()) {}
+    explicit Storage(SegmentedBuffer s) : segments(std::move(s)), size(segments.size()), segmented(true) {}
+    explicit Storage(MappedFile m) : mapping(std::move(m)), size(mapping.size()) {}
+
+    // Still in pooled blocks, not yet flattened
+    bool in_segments() const noexcept {
+        return segmented && !flattened.load(std::memory_order_acquire);
+    }
+
+    // Contiguous view. A segmented body is flattened on first use and its
+    // blocks go back to the pool, so only one copy stays in memory.
+    std::string_view contiguous() const {
+        if (!mapping.empty()) {
+            return mapping.view();
+        }
+        if (in_segments()) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!flattened.load(std::memory_order_relaxed)) {
+                data = segments.flatten(); // On bad_alloc the blocks stay intact
+                segments.clear();
+                flattened.store(true, std::memory_order_release);
+            }
+        }
+        return data;
+    }
+
+    mutable std::string data;         // Segmented bodies land here once flattened
+    mutable SegmentedBuffer segments; // Guarded by `mutex` while segmented
+    const MappedFile mapping;
+    const size_t size;
+    const bool segmented{false};
+    mutable std::mutex mutex;
+    mutable std::atomic<bool> flattened{false};
+    BudgetLease lease;
+};
+
+ResponseBody::ResponseBody(std::string body) {
+    if (!body.empty()) {
+        storage_ = std::make_shared<Storage>(std::move(body));
+    }
+}
+
+ResponseBody::ResponseBody(std::string_view body) : ResponseBody(std::string(body)) {}
+
+ResponseBody::ResponseBody(const char* body) : ResponseBody(std::string(body ? body : "")) {}
+
+ResponseBody::ResponseBody(SegmentedBuffer segments) {
+    if (!segments.empty()) {
+        storage_ = std::make_shared<Storage>(std::move(segments));
+    }
+}
+
+ResponseBody::ResponseBody(MappedFile mapping) {
+    if (!mapping.empty()) {
+        storage_ = std::make_shared<Storage>(std::move(mapping));
+    }
+}
+
+std::string_view ResponseBody::view() const {
+    return storage_ ? storage_->contiguous() : std::string_view();
+}
+
+size_t ResponseBody::size() const noexcept {
+    return storage_ ? storage_->size : 0;
+}
+
+std::string_view ResponseBody::substr(size_t pos, size_t count) const {
+    const std::string_view v = view();
+    if (pos > v.size()) {
+        throw std::out_of_range("ResponseBody::substr position out of range");
+    }
+    return v.substr(pos, count);
+}
+
+bool ResponseBody::is_segmented() const noexcept {
+    return storage_ && storage_->in_segments();
+}
+
+bool ResponseBody::is_mapped() const noexcept {
+    return storage_ && !storage_->mapping.empty();
+}
+
+std::vector<std::span<const char>> ResponseBody::spans() const {
+    if (!storage_) {
+        return {};
+    }
+    if (storage_->in_segments()) {
+        std::lock_guard<std::mutex> lock(storage_->mutex);
+        if (!storage_->flattened.load(std::memory_order_relaxed)) {
+            return storage_->segments.spans();
+        }
+    }
+    const std::string_view v = storage_->contiguous();
+    return {std::span<const char>(v.data(), v.size())};
+}
+
+std::string ResponseBody::str() const {
+    if (is_segmented()) {
+        std::lock_guard<std::mutex> lock(storage_->mutex);
+        if (!storage_->flattened.load(std::memory_order_relaxed)) {
+            return storage_->segments.flatten(); // A copy for the caller; the blocks stay
+        }
+    }
+    return std::string(view());
+}
+
+std::ostream& operator<<(std::ostream& os, const ResponseBody& body) {
+    if (body.is_segmented()) {
+        std::lock_guard<std::mutex> lock(body.storage_->mutex);
+        if (!body.storage_->flattened.load(std::memory_order_relaxed)) {
+            for (const auto& span : body.storage_->segments.spans()) {
+                os.write(span.data(), static_cast<std::streamsize>(span.size()));
+            }
+            return os;
+        }
+    }
+    const std::string_view v = body.view();
+    return os.write(v.data(), static_cast<std::streamsize>(v.size()));
+}
+
+long ResponseBody::use_count() const noexcept {
+    return storage_.use_count();
+}
+
+bool ResponseBody::shares_buffer_with(const ResponseBody& other) const noexcept {
+    return storage_ && storage_ == other.storage_;
+}
+
+void ResponseBody::hold(BudgetLease lease) {
+    if (storage_) {
+        storage_->lease = std::move(lease);
+    }
+}
+
+} // namespace CurlX
@@ -0,0 +1,345 @@
+#include "CurlX/Runtime.hpp"
+#include "CurlX/Exceptions.hpp"
+#include "CurlX/Statistics.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+namespace CurlX {
+
+namespace {
+    // Every block starts with a header so free/realloc know the size and class
+    struct alignas(std::max_align_t) BlockHeader {
+        size_t size;       // Bytes requested by libcurl
+        size_t size_class; // Index into the pooled classes, or LARGE_CLASS
+    };
+
+    constexpr size_t MIN_CLASS_SIZE = 16;
+    constexpr size_t CLASS_COUNT = std::bit_width(Runtime::MAX_POOLED_SIZE / MIN_CLASS_SIZE); // 16B .. 4KB
+    constexpr size_t LARGE_CLASS = CLASS_COUNT;
+
+    constexpr size_t class_for(size_t size) noexcept {
+        if (size <= MIN_CLASS_SIZE) return 0;
+        return std::bit_width(size - 1) - std::bit_width(MIN_CLASS_SIZE - 1);
+    }
+
+    constexpr size_t class_capacity(size_t size_class) noexcept {
+        return MIN_CLASS_SIZE << size_class;
+    }
+
+    static_assert(class_for(MIN_CLASS_SIZE) == 0);
+    static_assert(class_for(MIN_CLASS_SIZE + 1) == 1);
+    static_assert(class_for(Runtime::MAX_POOLED_SIZE) == CLASS_COUNT - 1);
+
+    // Striped like SessionCounters: each thread counts in its own padded
+    // shard, so libcurl's malloc/free never write a cache line shared with
+    // other threads. bytes_in_use is signed per shard because a block may be
+    // freed on a different thread than the one that allocated it.
+    struct alignas(64) CounterShard {
+        std::atomic<size_t> allocations{0};
+        std::atomic<size_t> frees{0};
+        std::atomic<size_t> reallocations{0};
+        std::atomic<size_t> bytes_allocated{0};
+        std::atomic<int64_t> bytes_in_use{0};
+        std::atomic<int64_t> peak_bytes_in_use{0}; // Highest bytes_in_use of this shard
+        std::atomic<size_t> cache_hits{0};
+    };
+
+    constexpr size_t MAX_COUNTER_SHARDS = 64; // counter_shards() never exceeds this
+
+    CounterShard allocation_shards[MAX_COUNTER_SHARDS];
+    std::atomic<size_t> observed_peak{0}; // Highest total seen by allocation_stats()
+
+    CounterShard& local_counters() noexcept {
+        return allocation_shards[thread_slot() & (counter_shards() - 1)];
+    }
+
+    void add_in_use(CounterShard& shard, int64_t delta) noexcept {
+        const int64_t in_use = shard.bytes_in_use.fetch_add(delta, std::memory_order_relaxed) + delta;
+        int64_t peak = shard.peak_bytes_in_use.load(std::memory_order_relaxed);
+        // Only threads sharing this shard compete here
+        while (in_use > peak && !shard.peak_bytes_in_use.compare_exchange_weak(peak, in_use, std::memory_order_relaxed)) {
+        }
+    }
+
+    void record_allocation(size_t size) noexcept {
+        CounterShard& shard = local_counters();
+        shard.allocations.fetch_add(1, std::memory_order_relaxed);
+        shard.bytes_allocated.fetch_add(size, std::memory_order_relaxed);
+        add_in_use(shard, static_cast<int64_t>(size));
+    }
+
+    void record_free(size_t size) noexcept {
+        CounterShard& shard = local_counters();
+        shard.frees.fetch_add(1, std::memory_order_relaxed);
+        shard.bytes_in_use.fetch_sub(static_cast<int64_t>(size), std::memory_order_relaxed);
+    }
+
+    // Per-thread free lists, linked through the first word of each cached block.
+    // Trivially destructible so it stays readable while other thread_locals are torn down.
+    struct ThreadCache {
+        void* free_lists[CLASS_COUNT];
+        size_t counts[CLASS_COUNT];
+    };
+
+    enum class CacheState : unsigned char { Unused, Live, Destroyed };
+
+    thread_local ThreadCache thread_cache;
+    thread_local CacheState thread_cache_state = CacheState::Unused;
+
+    void flush_thread_cache() noexcept {
+        for (size_t c = 0; c < CLASS_COUNT; ++c) {
+            void* block = thread_cache.free_lists[c];
+            while (block) {
+                void* next = *static_cast<void**>(block);
+                std::free(block);
+                block = next;
+            }
+            thread_cache.free_lists[c] = nullptr;
+            thread_cache.counts[c] = 0;
+        }
+    }
+
+    // Returns cached blocks to malloc when the thread exits
+    struct ThreadCacheReaper {
+        ~ThreadCacheReaper() {
+            flush_thread_cache();
+            thread_cache_state = CacheState::Destroyed;
+        }
+    };
+
+    thread_local ThreadCacheReaper thread_cache_reaper;
+
+    ThreadCache* local_cache() noexcept {
+        if (thread_cache_state == CacheState::Live) {
+            return &thread_cache;
+        }
+        if (thread_cache_state == CacheState::Unused) {
+            (void)&thread_cache_reaper; // Registers the thread-exit flush
+            thread_cache_state = CacheState::Live;
+            return &thread_cache;
+        }
+        return nullptr; // Thread is exiting: go straight to malloc
+    }
+
+    template<bool Pooled>
+    void* builtin_malloc(size_t size) {
+        if (size == 0) size = 1;
+        const size_t size_class = (Pooled && size <= Runtime::MAX_POOLED_SIZE) ? class_for(size) : LARGE_CLASS;
+
+        void* raw = nullptr;
+        if (size_class != LARGE_CLASS) {
+            ThreadCache* cache = local_cache();
+            if (cache && cache->free_lists[size_class]) {
+                raw = cache->free_lists[size_class];
+                cache->free_lists[size_class] = *static_cast<void**>(raw);
+                --cache->counts[size_class];
+                local_counters().cache_hits.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                raw = std::malloc(sizeof(BlockHeader) + class_capacity(size_class));
+            }
+        } else {
+            raw = std::malloc(sizeof(BlockHeader) + size);
+        }
+        if (!raw) return nullptr;
+
+        auto* header = static_cast<BlockHeader*>(raw);
+        header->size = size;
+        header->size_class = size_class;
+        record_allocation(size);
+        return header + 1;
+    }
+
+    template<bool Pooled>
+    void builtin_free(void* ptr) {
+        if (!ptr) return;
+
+        auto* header = static_cast<BlockHeader*>(ptr) - 1;
+        record_free(header->size);
+
+        if (Pooled && header->size_class != LARGE_CLASS) {
+            ThreadCache* cache = local_cache();
+            const size_t size_class = header->size_class;
+            if (cache && cache->counts[size_class] < Runtime::THREAD_CACHE_BLOCKS) {
+                *reinterpret_cast<void**>(header) = cache->free_lists[size_class];
+                cache->free_lists[size_class] = header;
+                ++cache->counts[size_class];
+                return;
+            }
+        }
+        std::free(header);
+    }
+
+    template<bool Pooled>
+    void* builtin_realloc(void* ptr, size_t size) {
+        if (!ptr) return builtin_malloc<Pooled>(size);
+        if (size == 0) size = 1;
+
+        CounterShard& shard = local_counters();
+        shard.reallocations.fetch_add(1, std::memory_order_relaxed);
+        auto* header = static_cast<BlockHeader*>(ptr) - 1;
+        const size_t old_size = header->size;
+
+        // Still fits the pooled block: adjust in place
+        if (header->size_class != LARGE_CLASS && size <= class_capacity(header->size_class)) {
+            header->size = size;
+            add_in_use(shard, static_cast<int64_t>(size) - static_cast<int64_t>(old_size));
+            return ptr;
+        }
+
+        // Large stays large: let malloc grow it
+        if (header->size_class == LARGE_CLASS && (!Pooled || size > Runtime::MAX_POOLED_SIZE)) {
+            void* raw = std::realloc(header, sizeof(BlockHeader) + size);
+            if (!raw) return nullptr;
+            header = static_cast<BlockHeader*>(raw);
+            header->size = size;
+            record_free(old_size);
+            record_allocation(size);
+            return header + 1;
+        }
+
+        void* moved = builtin_malloc<Pooled>(size);
+        if (!moved) return nullptr;
+        std::memcpy(moved, ptr, old_size < size ? old_size : size);
+        builtin_free<Pooled>(ptr);
+        return moved;
+    }
+
+    template<bool Pooled>
+    char* builtin_strdup(const char* str) {
+        const size_t length = std::strlen(str) + 1;
+        auto* copy = static_cast<char*>(builtin_malloc<Pooled>(length));
+        if (copy) {
+            std::memcpy(copy, str, length);
+        }
+        return copy;
+    }
+
+    template<bool Pooled>
+    void* builtin_calloc(size_t count, size_t size) {
+        size_t total;
+        if (__builtin_mul_overflow(count, size, &total)) {
+            return nullptr;
+        }
+        void* ptr = builtin_malloc<Pooled>(total);
+        if (ptr) {
+            std::memset(ptr, 0, total);
+        }
+        return ptr;
+    }
+
+    template<bool Pooled>
+    constexpr CurlAllocator builtin_allocator() {
+        return CurlAllocator{builtin_malloc<Pooled>, builtin_free<Pooled>, builtin_realloc<Pooled>,
+                             builtin_strdup<Pooled>, builtin_calloc<Pooled>};
+    }
+
+    std::mutex init_mutex;
+    std::atomic<bool> initialized{false};
+    Runtime::Allocator active_allocator{Runtime::Allocator::System};
+    bool custom_allocator{false};
+
+    // Caller holds init_mutex
+    void global_init(const CurlAllocator* allocator, long flags) {
+        if (initialized.load(std::memory_order_relaxed)) {
+            throw RequestException("CurlX runtime is already initialized; call Runtime::initialize before creating any Session");
+        }
+
+        const CURLcode code = allocator
+            ? curl_global_init_mem(flags, allocator->malloc_fn, allocator->free_fn, allocator->realloc_fn,
+                                   allocator->strdup_fn, allocator->calloc_fn)
+            : curl_global_init(flags);
+        if (code != CURLE_OK) {
+            throw RequestException(std::string("Failed to initialize libcurl: ") + curl_easy_strerror(code));
+        }
+        initialized.store(true, std::memory_order_release);
+    }
+}
+
+void Runtime::initialize(Allocator allocator, long flags) {
+    std::lock_guard<std::mutex> lock(init_mutex);
+    switch (allocator) {
+        case Allocator::System: {
+            global_init(nullptr, flags);
+            break;
+        }
+        case Allocator::Counting: {
+            static constexpr CurlAllocator counting = builtin_allocator<false>();
+            global_init(&counting, flags);
+            break;
+        }
+        case Allocator::Pooled: {
+            static constexpr CurlAllocator pooled = builtin_allocator<true>();
+            global_init(&pooled, flags);
+            break;
+        }
+    }
+    active_allocator = allocator;
+}
+
+void Runtime::initialize(const CurlAllocator& allocator, long flags) {
+    if (!allocator.complete()) {
+        throw RequestException("CurlAllocator must provide malloc, free, realloc, strdup and calloc");
+    }
+    std::lock_guard<std::mutex> lock(init_mutex);
+    global_init(&allocator, flags);
+    custom_allocator = true;
+}
+
+void Runtime::ensure_initialized() {
+    if (initialized.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(init_mutex);
+    if (!initialized.load(std::memory_order_relaxed)) {
+        global_init(nullptr, CURL_GLOBAL_ALL);
+    }
+}
+
+bool Runtime::is_initialized() noexcept {
+    return initialized.load(std::memory_order_acquire);
+}
+
+Runtime::Allocator Runtime::allocator() noexcept {
+    std::lock_guard<std::mutex> lock(init_mutex);
+    return active_allocator;
+}
+
+bool Runtime::has_custom_allocator() noexcept {
+    std::lock_guard<std::mutex> lock(init_mutex);
+    return custom_allocator;
+}
+
+AllocationStats Runtime::allocation_stats() noexcept {
+    AllocationStats stats;
+    int64_t in_use = 0;
+    int64_t shard_peak = 0;
+    for (size_t i = 0; i < counter_shards(); ++i) {
+        const CounterShard& shard = allocation_shards[i];
+        stats.allocations += shard.allocations.load(std::memory_order_relaxed);
+        stats.frees += shard.frees.load(std::memory_order_relaxed);
+        stats.reallocations += shard.reallocations.load(std::memory_order_relaxed);
+        stats.bytes_allocated += shard.bytes_allocated.load(std::memory_order_relaxed);
+        stats.cache_hits += shard.cache_hits.load(std::memory_order_relaxed);
+        in_use += shard.bytes_in_use.load(std::memory_order_relaxed);
+        shard_peak = std::max(shard_peak, shard.peak_bytes_in_use.load(std::memory_order_relaxed));
+    }
+    // Shards are read one after another, so a free counted before its
+    // allocation can briefly make the sum negative
+    stats.bytes_in_use = in_use > 0 ? static_cast<size_t>(in_use) : 0;
+
+    // The process-wide peak is never summed on the hot path: report the
+    // highest of any one shard's peak and every total seen here
+    size_t peak = std::max(stats.bytes_in_use, static_cast<size_t>(shard_peak));
+    size_t seen = observed_peak.load(std::memory_order_relaxed);
+    while (peak > seen && !observed_peak.compare_exchange_weak(seen, peak, std::memory_order_relaxed)) {
+    }
+    stats.peak_bytes_in_use = std::max(peak, seen);
+    return stats;
+}
+
+} // namespace CurlX
@@ -1,4 +1,7 @@
 #include "CurlX/Session.hpp"
+#include "CurlX/Arena.hpp"
+#include "CurlX/Runtime.hpp"
+#include "CurlX/Encoding.hpp"
 #include "CurlX/Response.hpp"
 #include "CurlX/Request.hpp"
 #include "CurlX/Headers.hpp"
@@ -7,6 +10,7 @@
 #include "CurlX/Cookies.hpp"
 #include "CurlX/Auth.hpp"
 #include "CurlX/Exceptions.hpp"
+#include "CurlX/Probes.hpp"
 #include <curl/curl.h>
 #include <string>
 #include <iostream>
@@ -21,44 +25,159 @@
 #include <future>
 #include <memory>
 #include <cassert>
+#include <optional>
+#include <cmath>
+
+#ifdef CURLX_HAVE_USDT
+// Probe semaphores (see Probes.hpp). Tracers find them through the probe notes
+// and increment them while attached.
+extern "C" {
+#define CURLX_SEMAPHORE __attribute__((section(".probes"))) volatile unsigned short
+CURLX_SEMAPHORE curlx_request__start_semaphore = 0;
+CURLX_SEMAPHORE curlx_dns__done_semaphore = 0;
+CURLX_SEMAPHORE curlx_connect_semaphore = 0;
+CURLX_SEMAPHORE curlx_first__byte_semaphore = 0;
+CURLX_SEMAPHORE curlx_body__chunk_semaphore = 0;
+CURLX_SEMAPHORE curlx_request__done_semaphore = 0;
+CURLX_SEMAPHORE curlx_request__error_semaphore = 0;
+#undef CURLX_SEMAPHORE
+}
+#endif
 
 namespace CurlX {
 
 // Enhanced helper functions with safety checks
 namespace {
-    // Safe URL encoding with bounds checking
-    std::string safe_url_encode(std::string_view value) {
-        if (value.empty()) return {};
-        
-        std::ostringstream escaped;
-        escaped.fill('0');
-        escaped << std::hex;
+    // Destination for response body bytes while a transfer is in flight.
+    // Enforces the body limit, charges the memory budget and moves the body
+    // to disk past the spill threshold or when the budget runs out.
+    struct BodySink {
+        BodySink(BodyStorage s, const LIMITS& l, std::shared_ptr<MemoryBudget> budget)
+            : storage(s), limits(l), lease(std::move(budget)) {}
+
+        bool append(const char* data, size_t length) {
+            if (limits.has_body_limit() && received + length > limits.max_body_size) {
+                limit_exceeded = true;
+                return false;
+            }
+            if (!spill) {
+                if (limits.spills() && received + length > limits.spill_threshold) {
+                    start_spill();
+                } else if (lease && !charge(length)) {
+                    start_spill();
+                    lease.budget()->record_spill();
+                }
+            }
+            
+            if (spill) {
+                spill->write(data, length);
+            } else if (storage == BodyStorage::Segmented) {
+                segments.append(data, length);
+            } else {
+                contiguous.append(data, length);
+            }
+            received += length;
+            return true;
+        }
+
+        // Charge bytes to the memory budget; false when they must go to disk instead
+        bool charge(size_t length) {
+            const MemoryBudget& budget = *lease.budget();
+            if (received + length <= budget.small_body_allowance()) {
+                lease.grow(length); // Small bodies never spill
+                return true;
+            }
+            if (lease.try_grow(length)) {
+                return true;
+            }
+            if (budget.policy() == MemoryBudget::Overflow::Spill) {
+                return false;
+            }
+            lease.grow(length); // Delay policy: in-flight transfers run to completion
+            return true;
+        }
 
-        for (unsigned char c : value) {
-            if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
-                escaped << static_cast<char>(c);
+        void start_spill() {
+            spill.emplace(limits.spill_directory);
+            if (storage == BodyStorage::Segmented) {
+                for (const auto& span : segments.spans()) {
+                    spill->write(span.data(), span.size());
+                }
+                segments.clear();
+            } else {
+                spill->write(contiguous.data(), contiguous.size());
+                std::string().swap(contiguous);
+            }
+            lease.release(); // Spilled bytes live in the page cache, not the heap
+        }
+
+        // No limit, budget or spill checks (policies without enforce_limits)
+        void append_unchecked(const char* data, size_t length) {
+            if (storage == BodyStorage::Segmented) {
+                segments.append(data, length);
             } else {
-                escaped << '%' << std::setw(2) << static_cast<int>(c);
+                contiguous.append(data, length);
             }
+            received += length;
+        }
+
+        ResponseBody finish() {
+            if (spill) {
+                return ResponseBody(spill->map());
+            }
+            ResponseBody body = storage == BodyStorage::Segmented
+                ? ResponseBody(std::move(segments))
+                : ResponseBody(std::move(contiguous));
+            body.hold(std::move(lease));
+            return body;
+        }
+
+        BodyStorage storage;
+        const LIMITS& limits;
+        BudgetLease lease;
+        std::string contiguous;
+        SegmentedBuffer segments;
+        std::optional<SpillFile> spill;
+        size_t received{0};
+        bool limit_exceeded{false};
+        std::string error;
+        uint64_t request_id{0}; // For tracepoints
+        std::chrono::nanoseconds* cpu{nullptr}; // Callback CPU time, with CPU accounting on
+    };
+
+    template<typename Policy>
+    bool store_body(BodySink* sink, const void* contents, size_t length) {
+        if constexpr (Policy::enforce_limits) {
+            return sink->append(static_cast<const char*>(contents), length);
+        } else {
+            sink->append_unchecked(static_cast<const char*>(contents), length);
+            return true;
         }
-        return escaped.str();
     }
 
     // Enhanced write callback with safety checks
-    size_t safe_write_callback(void* contents, size_t size, size_t nmemb, std::string* s) noexcept {
-        if (!contents || !s || size == 0 || nmemb == 0) {
+    template<typename Policy>
+    size_t safe_write_callback(void* contents, size_t size, size_t nmemb, BodySink* sink) noexcept {
+        if constexpr (!Policy::guard_callbacks) {
+            CpuScope cpu(sink->cpu);
+            CURLX_PROBE(body__chunk, sink->request_id, size * nmemb);
+            return store_body<Policy>(sink, contents, size * nmemb) ? size * nmemb : 0;
+        }
+        
+        if (!contents || !sink || size == 0 || nmemb == 0) {
             return 0;
         }
+        CpuScope cpu(sink->cpu);
+        CURLX_PROBE(body__chunk, sink->request_id, size * nmemb);
         
         try {
             const size_t new_length = size * nmemb;
-            // Prevent excessive memory allocation
-            if (new_length > 100 * 1024 * 1024) { // 100MB limit
-                return 0;
+            if (!store_body<Policy>(sink, contents, new_length)) {
+                return 0; // Body limit reached
             }
-            s->append(static_cast<const char*>(contents), new_length);
             return new_length;
-        } catch (const std::exception&) {
+        } catch (const std::exception& e) {
+            sink->error = e.what();
             return 0;
         }
     }
@@ -77,23 +196,160 @@ namespace {
         return result;
     }
 
+    // Response headers of one transfer, and what the tracepoints need
+    struct HeaderSink {
+        HEADERS* headers;
+        CURL* handle;
+        uint64_t request_id;
+        bool first_byte{false};
+        std::chrono::nanoseconds* cpu{nullptr}; // As in BodySink
+    };
+
+#if defined(CURLX_HAVE_USDT) && LIBCURL_VERSION_NUM >= 0x075000 // 7.80.0
+    // CURLOPT_PREREQFUNCTION: connected (or reused), about to send the request
+    int probe_connected(void* data, char* primary_ip, char*, int primary_port, int) noexcept {
+        const HeaderSink& sink = *static_cast<HeaderSink*>(data);
+        curl_off_t lookup = 0;
+        curl_off_t connect = 0;
+        curl_easy_getinfo(sink.handle, CURLINFO_NAMELOOKUP_TIME_T, &lookup);
+        curl_easy_getinfo(sink.handle, CURLINFO_CONNECT_TIME_T, &connect);
+        CURLX_PROBE(dns__done, sink.request_id, lookup);
+        CURLX_PROBE(connect, sink.request_id, primary_ip, primary_port, connect);
+        return CURL_PREREQFUNC_OK;
+    }
+#endif
+
     // Enhanced header callback with validation
-    size_t safe_header_callback(char* buffer, size_t size, size_t nitems, HEADERS* headers) noexcept {
-        if (!buffer || !headers || size == 0 || nitems == 0) {
-            return 0;
+    template<typename Policy>
+    size_t safe_header_callback(char* buffer, size_t size, size_t nitems, HeaderSink* sink) noexcept {
+        if constexpr (Policy::guard_callbacks) {
+            if (!buffer || !sink || size == 0 || nitems == 0) {
+                return 0;
+            }
+        }
+        CpuScope cpu(sink->cpu);
+        if (CURLX_PROBE_ENABLED(first__byte) && !sink->first_byte) {
+            sink->first_byte = true;
+            CURLX_PROBE(first__byte, sink->request_id);
+        }
+        HEADERS* headers = sink->headers;
+        
+        const std::string_view header(buffer, size * nitems);
+        if (header.rfind("HTTP/", 0) == 0) {
+            // New status line: keep only the headers of the final response
+            headers->clear();
+            return size * nitems;
+        }
+        
+        if constexpr (!Policy::validate_headers) {
+            if (header.length() > 2) {
+                headers->add_unchecked(header.substr(0, header.length() - 2));
+            }
+            return size * nitems;
         }
         
         try {
-            const std::string header(buffer, size * nitems);
             if (header.length() > 2 && header.length() < 8192) { // Reasonable header size limit
                 // Remove \r\n safely
-                const std::string clean_header = header.substr(0, header.length() - 2);
-                headers->add(clean_header);
+                headers->add(header.substr(0, header.length() - 2));
             }
-            return size * nitems;
         } catch (const std::exception&) {
-            return 0;
+            // Skip malformed or oversized header lines instead of failing the transfer
+        }
+        return size * nitems;
+    }
+
+    // Owners for per-request libcurl resources, so every exit path releases them
+    struct SlistDeleter {
+        void operator()(curl_slist* list) const noexcept { curl_slist_free_all(list); }
+    };
+    struct MimeDeleter {
+        void operator()(curl_mime* mime) const noexcept { curl_mime_free(mime); }
+    };
+    struct FileCloser {
+        void operator()(FILE* file) const noexcept { std::fclose(file); }
+    };
+
+    // Whole milliseconds for CURLOPT_*_MS, rounded up so 0.0004s is not "no limit"
+    long to_milliseconds(double seconds) noexcept {
+        if (!(seconds > 0.0)) return 0;
+        return static_cast<long>(std::ceil(seconds * 1000.0));
+    }
+
+    // Low-speed detection with millisecond windows (CURLOPT_LOW_SPEED_TIME takes whole seconds).
+    // Checked whenever libcurl reports progress, which is at least once a second.
+    struct StallMonitor {
+        size_t min_bytes_per_second{0};
+        std::chrono::milliseconds window{0};
+        std::chrono::steady_clock::time_point window_start{};
+        curl_off_t window_bytes{0};
+        bool stalled{false};
+
+        bool enabled() const noexcept { return min_bytes_per_second > 0 && window.count() > 0; }
+
+        void start() noexcept {
+            window_start = std::chrono::steady_clock::now();
+            window_bytes = 0;
+            stalled = false;
+        }
+
+        // False once the transfer moved too few bytes over a full window
+        bool check(curl_off_t transferred) noexcept {
+            const auto now = std::chrono::steady_clock::now();
+            if (transferred < window_bytes) {
+                // libcurl restarts the counters for each redirect hop: start a new window
+                window_start = now;
+                window_bytes = transferred;
+                return true;
+            }
+            if (now - window_start < window) {
+                return true;
+            }
+            const double seconds = std::chrono::duration<double>(now - window_start).count();
+            if (static_cast<double>(transferred - window_bytes) < static_cast<double>(min_bytes_per_second) * seconds) {
+                stalled = true;
+                return false;
+            }
+            window_start = now;
+            window_bytes = transferred;
+            return true;
+        }
+    };
+
+    int stall_callback(void* data, curl_off_t, curl_off_t dlnow, curl_off_t, curl_off_t ulnow) noexcept {
+        return static_cast<StallMonitor*>(data)->check(dlnow + ulnow) ? 0 : 1;
+    }
+
+    // Per-phase times in microseconds (the *_TIME_T infos, not the rounded doubles)
+    TIMINGS read_timings(CURL* handle) noexcept {
+        const auto info = [handle](CURLINFO what) {
+            curl_off_t value = 0;
+            curl_easy_getinfo(handle, what, &value);
+            return TIMINGS::Duration(value);
+        };
+        TIMINGS timings;
+        timings.name_lookup = info(CURLINFO_NAMELOOKUP_TIME_T);
+        timings.connect = info(CURLINFO_CONNECT_TIME_T);
+        timings.app_connect = info(CURLINFO_APPCONNECT_TIME_T);
+        timings.pre_transfer = info(CURLINFO_PRETRANSFER_TIME_T);
+        timings.start_transfer = info(CURLINFO_STARTTRANSFER_TIME_T);
+        timings.total = info(CURLINFO_TOTAL_TIME_T);
+        timings.redirect = info(CURLINFO_REDIRECT_TIME_T);
+        curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &timings.new_connections);
+        return timings;
+    }
+
+    // Phase of a failed transfer, from the result code and how far the transfer got
+    Error::Phase transfer_phase(CURL* handle, CURLcode code) noexcept {
+        if (code == CURLE_COULDNT_RESOLVE_HOST || code == CURLE_COULDNT_RESOLVE_PROXY) {
+            return Error::Phase::Resolve;
         }
+        curl_off_t connect_time = 0;
+        curl_easy_getinfo(handle, CURLINFO_CONNECT_TIME_T, &connect_time);
+        if (connect_time == 0 || code == CURLE_SSL_CONNECT_ERROR) {
+            return Error::Phase::Connect;
+        }
+        return Error::Phase::Transfer;
     }
 
     // Safe string operations
@@ -108,6 +364,51 @@ namespace {
     }
 }
 
+// One request's libcurl state, from setting the options until the response is built.
+// perform() keeps it on the stack; AsyncSession keeps one per transfer in flight.
+template<typename Policy>
+struct BasicSession<Policy>::Transfer {
+    Transfer(CURL* h, const REQUEST& r, const LIMITS& l, BodyStorage storage, const HEADERS& default_headers,
+             std::shared_ptr<MemoryBudget> budget, std::pmr::memory_resource* resource)
+        : handle(h)
+        , request(r)
+        , limits(l)
+        , transient(resource)
+        , response_body(storage, l, std::move(budget))
+        , response_headers(resource)
+        , effective_headers(default_headers, resource)
+        , id(next_request_id())
+        , header_sink{&response_headers, h, id} {
+        response_body.request_id = id;
+    }
+    
+    CURL* handle;
+    const REQUEST& request;
+    const LIMITS& limits;
+    std::pmr::memory_resource* transient;
+    BodySink response_body;
+    HEADERS response_headers;
+    HEADERS effective_headers;
+    uint64_t id;
+    HeaderSink header_sink;
+    std::optional<DebugRecorder> debug; // With DEBUG_CAPTURE set
+    PendingTrace pending_trace;         // Kept by finish_transfer, delivered without session_mutex_
+    CPU_TIME cpu;
+    bool account_cpu{false};
+    StallMonitor stall;
+    std::shared_ptr<const ParsedURL> parsed_url; // Owns the CURLU handed to libcurl
+    ParsedURL::Handle request_url;
+    std::unique_ptr<curl_slist, SlistDeleter> header_list;
+    std::unique_ptr<curl_mime, MimeDeleter> mime;
+    std::unique_ptr<FILE, FileCloser> output_file;
+    ConnectionStats::Tap connection_tap;
+};
+
+template<typename Policy>
+void BasicSession<Policy>::TransferDeleter::operator()(Transfer* transfer) const noexcept {
+    delete transfer;
+}
+
 // SessionPool implementation
 SessionPool::SessionPool(size_t max_size) : max_size_(max_size) {
     if (max_size_ == 0) max_size_ = 1;
@@ -166,63 +467,95 @@ size_t SessionPool::available() const noexcept {
 }
 
 // Session implementation
-Session::Session(bool enable_connection_pooling) 
+template<typename Policy>
+BasicSession<Policy>::BasicSession(bool enable_connection_pooling) 
     : pooling_enabled_(enable_connection_pooling) {
     initialize_curl_handle();
 }
 
-Session::Session(Session&& other) noexcept 
+template<typename Policy>
+BasicSession<Policy>::BasicSession(BasicSession&& other) noexcept 
     : curl_handle_(std::move(other.curl_handle_))
+    , multi_handle_(std::move(other.multi_handle_))
     , default_headers_(std::move(other.default_headers_))
     , default_cookies_(std::move(other.default_cookies_))
     , cookie_jar_path_(std::move(other.cookie_jar_path_))
-    , request_count_(other.request_count_.load())
-    , total_response_time_(other.total_response_time_.load())
+    , counters_(std::move(other.counters_))
+    , latency_stats_(std::move(other.latency_stats_))
+    , traffic_stats_(std::move(other.traffic_stats_))
+    , connection_stats_(std::move(other.connection_stats_))
     , connection_pool_(std::move(other.connection_pool_))
     , pooling_enabled_(other.pooling_enabled_)
     , is_valid_(other.is_valid_.load())
     , connection_timeout_(other.connection_timeout_)
     , transfer_timeout_(other.transfer_timeout_)
+    , stall_min_bytes_per_second_(other.stall_min_bytes_per_second_)
+    , stall_window_(other.stall_window_)
     , max_connections_per_host_(other.max_connections_per_host_)
+    , connection_cache_size_(other.connection_cache_size_)
     , keep_alive_enabled_(other.keep_alive_enabled_)
-    , compression_enabled_(other.compression_enabled_) {
+    , compression_enabled_(other.compression_enabled_)
+    , body_storage_(other.body_storage_)
+    , request_arena_enabled_(other.request_arena_enabled_)
+    , limits_(std::move(other.limits_))
+    , memory_budget_(std::move(other.memory_budget_))
+    , debug_capture_(std::move(other.debug_capture_))
+    , cpu_accounting_(other.cpu_accounting_) {
     
     other.is_valid_.store(false);
-    other.request_count_.store(0);
-    other.total_response_time_.store(0.0);
 }
 
-Session& Session::operator=(Session&& other) noexcept {
+template<typename Policy>
+BasicSession<Policy>& BasicSession<Policy>::operator=(BasicSession&& other) noexcept {
     if (this != &other) {
         cleanup_curl_handle();
         
         curl_handle_ = std::move(other.curl_handle_);
+        multi_handle_ = std::move(other.multi_handle_);
         default_headers_ = std::move(other.default_headers_);
         default_cookies_ = std::move(other.default_cookies_);
         cookie_jar_path_ = std::move(other.cookie_jar_path_);
-        request_count_.store(other.request_count_.load());
-        total_response_time_.store(other.total_response_time_.load());
+        counters_ = std::move(other.counters_);
+        latency_stats_ = std::move(other.latency_stats_);
+        traffic_stats_ = std::move(other.traffic_stats_);
+        connection_stats_ = std::move(other.connection_stats_);
         connection_pool_ = std::move(other.connection_pool_);
         pooling_enabled_ = other.pooling_enabled_;
         is_valid_.store(other.is_valid_.load());
         connection_timeout_ = other.connection_timeout_;
         transfer_timeout_ = other.transfer_timeout_;
+        stall_min_bytes_per_second_ = other.stall_min_bytes_per_second_;
+        stall_window_ = other.stall_window_;
         max_connections_per_host_ = other.max_connections_per_host_;
+        connection_cache_size_ = other.connection_cache_size_;
         keep_alive_enabled_ = other.keep_alive_enabled_;
         compression_enabled_ = other.compression_enabled_;
+        body_storage_ = other.body_storage_;
+        request_arena_enabled_ = other.request_arena_enabled_;
+        limits_ = std::move(other.limits_);
+        if (memory_budget_) memory_budget_->unregister_session();
+        memory_budget_ = std::move(other.memory_budget_);
+        debug_capture_ = std::move(other.debug_capture_);
+        cpu_accounting_ = other.cpu_accounting_;
         
         other.is_valid_.store(false);
-        other.request_count_.store(0);
-        other.total_response_time_.store(0.0);
     }
     return *this;
 }
 
-Session::~Session() {
+template<typename Policy>
+BasicSession<Policy>::~BasicSession() {
     cleanup_curl_handle();
+    if (memory_budget_) {
+        memory_budget_->unregister_session();
+    }
 }
 
-void Session::initialize_curl_handle() {
+template<typename Policy>
+void BasicSession<Policy>::initialize_curl_handle() {
+    // Explicit global init, so a Runtime allocator is installed before libcurl allocates anything
+    Runtime::ensure_initialized();
+    
     CURL* handle = curl_easy_init();
     if (!handle) {
         throw RequestException("Failed to initialize CURL handle");
@@ -232,8 +565,8 @@ void Session::initialize_curl_handle() {
     curl_handle_ = std::unique_ptr<CURL, CurlHandleDeleter>(handle);
     
     // Apply default settings
-    apply_safety_settings();
-    apply_performance_settings();
+    apply_safety_settings(handle);
+    apply_performance_settings(handle);
     
     // Enable cookie engine by default (in-memory)
     curl_easy_setopt(handle, CURLOPT_COOKIEFILE, "");
@@ -244,7 +577,8 @@ void Session::initialize_curl_handle() {
     is_valid_.store(true);
 }
 
-void Session::cleanup_curl_handle() noexcept {
+template<typename Policy>
+void BasicSession<Policy>::cleanup_curl_handle() noexcept {
     if (curl_handle_) {
         // Save cookies if jar path is set
         if (!cookie_jar_path_.empty()) {
@@ -256,16 +590,16 @@ void Session::cleanup_curl_handle() noexcept {
         }
         curl_handle_.reset();
     }
+    multi_handle_.reset(); // Closes its cached connections while connection_stats_ is alive
     is_valid_.store(false);
 }
 
-void Session::apply_safety_settings() {
-    if (!curl_handle_) return;
-    
-    CURL* handle = curl_handle_.get();
-    
-    // Set reasonable limits to prevent resource exhaustion
-    curl_easy_setopt(handle, CURLOPT_MAXFILESIZE_LARGE, static_cast<curl_off_t>(100 * 1024 * 1024)); // 100MB
+template<typename Policy>
+void BasicSession<Policy>::apply_safety_settings(CURL* handle) {
+    // Set reasonable limits to prevent resource exhaustion (0 = unlimited)
+    if constexpr (Policy::enforce_limits) {
+        curl_easy_setopt(handle, CURLOPT_MAXFILESIZE_LARGE, static_cast<curl_off_t>(limits_.max_body_size));
+    }
     curl_easy_setopt(handle, CURLOPT_BUFFERSIZE, 16384); // 16KB buffer
     curl_easy_setopt(handle, CURLOPT_MAXREDIRS, 10); // Limit redirects
     
@@ -283,20 +617,17 @@ void Session::apply_safety_settings() {
     #endif
 }
 
-void Session::apply_performance_settings() {
-    if (!curl_handle_) return;
-    
-    CURL* handle = curl_handle_.get();
-    
+template<typename Policy>
+void BasicSession<Policy>::apply_performance_settings(CURL* handle) {
     // Connection settings
-    curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT, static_cast<long>(connection_timeout_));
-    curl_easy_setopt(handle, CURLOPT_TIMEOUT, static_cast<long>(transfer_timeout_));
+    curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT_MS, to_milliseconds(connection_timeout_));
+    curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, to_milliseconds(transfer_timeout_));
     curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, keep_alive_enabled_ ? 1L : 0L);
     curl_easy_setopt(handle, CURLOPT_TCP_KEEPIDLE, 60L);
     curl_easy_setopt(handle, CURLOPT_TCP_KEEPINTVL, 60L);
     
     // Connection pooling
-    curl_easy_setopt(handle, CURLOPT_MAXCONNECTS, static_cast<long>(max_connections_per_host_));
+    curl_easy_setopt(handle, CURLOPT_MAXCONNECTS, static_cast<long>(connection_cache_size_));
     curl_easy_setopt(handle, CURLOPT_FORBID_REUSE, 0L);
     curl_easy_setopt(handle, CURLOPT_FRESH_CONNECT, 0L);
     
@@ -309,14 +640,23 @@ void Session::apply_performance_settings() {
     curl_easy_setopt(handle, CURLOPT_DNS_CACHE_TIMEOUT, 300L); // 5 minutes
 }
 
-void Session::validate_request(const REQUEST& request) const {
+// Fill `detail`, when asked for, and return the setup failure
+static Error setup_error(CURLcode code, std::string* detail, std::string_view message) {
+    if (detail) {
+        *detail = message;
+    }
+    return Error{code, Error::Phase::Setup};
+}
+
+template<typename Policy>
+std::optional<Error> BasicSession<Policy>::validate_request(const REQUEST& request, std::string* detail) const {
     if (!is_valid_.load()) {
-        throw RequestException("Session is not valid");
+        return setup_error(CURLE_FAILED_INIT, detail, "Session is not valid");
     }
     
     // Basic URL validation - check if URL is not empty
     if (request.get_url().toString().empty()) {
-        throw RequestException("Invalid URL in request");
+        return setup_error(CURLE_URL_MALFORMAT, detail, "Invalid URL in request");
     }
     
     // Validate file paths if present
@@ -327,245 +667,556 @@ void Session::validate_request(const REQUEST& request) const {
         if (last_slash != std::string::npos) {
             dir = dir.substr(0, last_slash);
             if (!dir.empty() && access(dir.c_str(), W_OK) != 0) {
-                throw RequestException("Output directory is not writable: " + dir);
+                return setup_error(CURLE_WRITE_ERROR, detail, "Output directory is not writable: " + dir);
             }
         }
     }
+    return std::nullopt;
+}
+
+template<typename Policy>
+RESPONSE BasicSession<Policy>::send(const REQUEST& request) {
+    std::string detail;
+    auto result = perform(request, &detail);
+    if (!result) {
+        result.error().raise(detail);
+    }
+    return std::move(*result);
+}
+
+template<typename Policy>
+std::expected<RESPONSE, Error> BasicSession<Policy>::try_send(const REQUEST& request) {
+    try {
+        return perform(request, nullptr);
+    } catch (const std::bad_alloc&) {
+        return std::unexpected(Error{CURLE_OUT_OF_MEMORY, Error::Phase::Setup});
+    } catch (...) {
+        // perform() reports request failures as values; this is the last resort
+        return std::unexpected(Error{CURLE_FAILED_INIT, Error::Phase::Setup});
+    }
 }
 
-RESPONSE Session::send(const REQUEST& request) {
-    const auto start_time = std::chrono::high_resolution_clock::now();
+template<typename Policy>
+std::expected<RESPONSE, Error> BasicSession<Policy>::perform(const REQUEST& request, std::string* detail) {
+    std::chrono::high_resolution_clock::time_point start_time{};
+    if constexpr (Policy::collect_statistics) {
+        start_time = std::chrono::high_resolution_clock::now();
+    }
+    const auto record_statistics = [&](CURLcode result, long status = 0, const Transfer* transfer = nullptr) {
+        if constexpr (Policy::collect_statistics) {
+            const auto end_time = std::chrono::high_resolution_clock::now();
+            update_statistics(request, transfer, result, status,
+                              std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time));
+        }
+    };
     
     try {
         // Validate request
-        validate_request(request);
+        if constexpr (Policy::validate_requests) {
+            if (const auto invalid = validate_request(request, detail)) {
+                record_statistics(invalid->code);
+                return std::unexpected(*invalid);
+            }
+        }
+        
+        // Cancelled before it started: nothing to send
+        const std::stop_token& stop_token = request.get_stop_token();
+        if (stop_token.stop_requested()) {
+            record_statistics(CURLE_ABORTED_BY_CALLBACK);
+            if (detail) {
+                *detail = "Request was cancelled before it started";
+            }
+            return std::unexpected(Error{CURLE_ABORTED_BY_CALLBACK, Error::Phase::Setup});
+        }
+        
+        // Backpressure: wait for buffered bytes to drain before starting
+        std::shared_ptr<MemoryBudget> budget;
+        if constexpr (Policy::enforce_limits) {
+            budget = with_lock([this] { return memory_budget_; });
+            if (budget && budget->policy() == MemoryBudget::Overflow::Delay &&
+                !budget->wait_for_capacity(request.get_timeout().remaining(), stop_token)) {
+                const bool cancelled = stop_token.stop_requested();
+                const CURLcode code = cancelled ? CURLE_ABORTED_BY_CALLBACK : CURLE_OPERATION_TIMEDOUT;
+                record_statistics(code);
+                if (detail) {
+                    *detail = cancelled ? "Request was cancelled while waiting for the memory budget"
+                                        : "Request timed out waiting for the memory budget";
+                }
+                return std::unexpected(Error{code, Error::Phase::Setup});
+            }
+        }
         
         // Acquire lock for thread safety
-        std::lock_guard<std::mutex> lock(session_mutex_);
+        std::unique_lock<std::mutex> lock(session_mutex_);
         
         if (!curl_handle_) {
-            throw RequestException("CURL handle is not available");
+            record_statistics(CURLE_FAILED_INIT);
+            return std::unexpected(setup_error(CURLE_FAILED_INIT, detail, "CURL handle is not available"));
+        }
+        
+        // Transient strings live in the thread's arena, released when this scope ends.
+        // Everything handed to the RESPONSE is copied out into the default resource.
+        std::optional<RequestArena::Scope> arena_scope;
+        std::pmr::memory_resource* transient = std::pmr::get_default_resource();
+        if (request_arena_enabled_) {
+            transient = arena_scope.emplace().resource();
         }
         
         CURL* handle = curl_handle_.get();
-        CURLcode res;
-        RESPONSE response;
-        std::string response_body;
-        HEADERS response_headers;
-        curl_mime* mime = nullptr;
-        FILE* output_file = nullptr;
+        const LIMITS& limits = request.get_limits() ? *request.get_limits() : limits_;
+        Transfer transfer(handle, request, limits, body_storage_, default_headers_, std::move(budget), transient);
+        if (const auto failed = prepare_transfer(transfer, detail)) {
+            record_statistics(failed->code);
+            return std::unexpected(*failed);
+        }
         
-        // Reset options for each request
-        curl_easy_reset(handle);
+        // Execute request
+        const auto cpu_start = transfer.account_cpu ? thread_cpu_time() : std::chrono::nanoseconds(0);
+        const CURLcode res = stop_token.stop_possible() ? perform_cancellable(handle, stop_token) : curl_easy_perform(handle);
+        if (transfer.account_cpu) {
+            transfer.cpu.libcurl = thread_cpu_time() - cpu_start - transfer.cpu.callbacks;
+        }
         
-        // Reapply settings
-        apply_safety_settings();
-        apply_performance_settings();
+        auto result = finish_transfer(transfer, res, detail);
+        record_statistics(result ? CURLE_OK : result.error().code, result ? result->statusCode : 0, &transfer);
         
-        // Build full URL with parameters
-        std::string full_url = request.get_url().toString();
-        if (!request.get_params().get().empty()) {
-            full_url += "?";
-            bool first_param = true;
-            for (const auto& pair : request.get_params().get()) {
-                if (!first_param) full_url += "&";
-                full_url += safe_url_encode(pair.first) + "=" + safe_url_encode(pair.second);
-                first_param = false;
+        // The debug sink runs unlocked, so a sink that waits on another send cannot deadlock
+        PendingTrace trace = std::move(transfer.pending_trace);
+        lock.unlock();
+        trace.deliver();
+        return result;
+        
+    } catch (...) {
+        // Out of memory and the like; update statistics even on failure
+        record_statistics(CURLE_FAILED_INIT);
+        throw;
+    }
+}
+
+template<typename Policy>
+typename BasicSession<Policy>::TransferPtr BasicSession<Policy>::new_transfer(
+    CURL* handle, const REQUEST& request, std::shared_ptr<MemoryBudget> budget, std::pmr::memory_resource* transient) {
+    const LIMITS& limits = request.get_limits() ? *request.get_limits() : limits_;
+    return TransferPtr(new Transfer(handle, request, limits, body_storage_, default_headers_, std::move(budget), transient));
+}
+
+// Set every option for one request on the transfer's handle, right before it starts.
+// Called with session_mutex_ held.
+template<typename Policy>
+std::optional<Error> BasicSession<Policy>::prepare_transfer(Transfer& transfer, std::string* detail) {
+    CURL* handle = transfer.handle;
+    const REQUEST& request = transfer.request;
+    const LIMITS& limits = transfer.limits;
+    std::pmr::memory_resource* transient = transfer.transient;
+    
+    // CPU accounting covers the whole of setup, early returns included
+    transfer.account_cpu = cpu_accounting_;
+    CpuScope cpu(transfer.account_cpu ? &transfer.cpu.setup : nullptr);
+    if (transfer.account_cpu) {
+        transfer.response_body.cpu = &transfer.cpu.callbacks;
+        transfer.header_sink.cpu = &transfer.cpu.callbacks;
+    }
+    
+    // Reset options for each request
+    curl_easy_reset(handle);
+    
+    // Reapply settings
+    apply_safety_settings(handle);
+    apply_performance_settings(handle);
+    if (Policy::enforce_limits && request.get_limits()) {
+        curl_easy_setopt(handle, CURLOPT_MAXFILESIZE_LARGE, static_cast<curl_off_t>(limits.max_body_size));
+    }
+    
+    // Per-request time limits. CURLOPT_TIMEOUT_MS covers redirects too; a deadline
+    // that has already passed (e.g. spent by earlier retries) fails before any I/O
+    const TIMEOUT& timeout = request.get_timeout();
+    if (const auto remaining = timeout.remaining()) {
+        if (remaining->count() == 0) {
+            if (detail) {
+                *detail = "Request deadline passed before the transfer started";
             }
+            return Error{CURLE_OPERATION_TIMEDOUT, Error::Phase::Setup};
         }
+        curl_easy_setopt(handle, CURLOPT_TIMEOUT_MS, static_cast<long>(remaining->count()));
+    }
+    if (timeout.connect.count() > 0) {
+        curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT_MS, static_cast<long>(timeout.connect.count()));
+    }
+    
+    StallMonitor& stall = transfer.stall;
+    if (timeout.detects_stalls()) {
+        stall.min_bytes_per_second = timeout.min_bytes_per_second;
+        stall.window = timeout.stall_window;
+    } else {
+        stall.min_bytes_per_second = stall_min_bytes_per_second_;
+        stall.window = stall_window_;
+    }
+    if (stall.enabled()) {
+        curl_easy_setopt(handle, CURLOPT_XFERINFOFUNCTION, stall_callback);
+        curl_easy_setopt(handle, CURLOPT_XFERINFODATA, &stall);
+        curl_easy_setopt(handle, CURLOPT_NOPROGRESS, 0L);
+    }
+    
+    // Hand libcurl the URL parsed once per URL object; parameters go into a
+    // per-request copy of the handle, with the query sized exactly in one pass
+    if (auto parsed = request.get_url().try_parsed()) {
+        transfer.parsed_url = std::move(*parsed);
+    } else {
+        if (detail) {
+            *detail = "Invalid URL '" + request.get_url().toString() + "': " + curl_url_strerror(parsed.error());
+        }
+        return Error{CURLE_URL_MALFORMAT, Error::Phase::Setup};
+    }
+    const ParsedURL& parsed_url = *transfer.parsed_url;
+    if constexpr (Policy::collect_statistics) {
+        connection_stats_.attach(handle, transfer.connection_tap, parsed_url.host_key());
+    }
+    const PARAMS& params = request.get_params();
+    CURLU* url_handle = parsed_url.handle();
+    if (!params.empty()) {
+        const std::string_view base_query = parsed_url.query();
+        const size_t query_size = base_query.size() + (base_query.empty() ? 0 : 1) + QueryBuilder::encoded_size(params);
+        std::pmr::string query(transient);
+        query.resize_and_overwrite(query_size, [&](char* out, size_t) {
+            out = std::copy(base_query.begin(), base_query.end(), out);
+            if (!base_query.empty()) *out++ = '&';
+            QueryBuilder::write(params, out);
+            return query_size;
+        });
         
-        curl_easy_setopt(handle, CURLOPT_URL, full_url.c_str());
-        curl_easy_setopt(handle, CURLOPT_CUSTOMREQUEST, request.get_method().c_str());
-        
-        // Handle file uploads
-        if (!request.files_.get().empty()) {
-            mime = curl_mime_init(handle);
-            if (!mime) {
-                throw RequestException("Failed to initialize MIME structure");
-            }
-            
-            for (const auto& file_pair : request.files_.get()) {
-                curl_mimepart* part = curl_mime_addpart(mime);
-                if (!part) continue;
-                
-                curl_mime_name(part, file_pair.first.c_str());
-                curl_mime_filedata(part, file_pair.second.c_str());
+        transfer.request_url = parsed_url.clone_handle();
+        if (curl_url_set(transfer.request_url.get(), CURLUPART_QUERY, query.c_str(), 0) != CURLUE_OK) {
+            return setup_error(CURLE_URL_MALFORMAT, detail, "Failed to set query parameters");
+        }
+        url_handle = transfer.request_url.get();
+    }
+    curl_easy_setopt(handle, CURLOPT_CURLU, url_handle);
+    
+    // Standard verbs use libcurl's own request modes; CURLOPT_CUSTOMREQUEST is the cold path
+    const bool has_body = !request.files_.get().empty() || !request.body_.toString().empty();
+    switch (request.get_method().verb()) {
+        case METHOD::Verb::GET:
+            if (has_body) {
+                curl_easy_setopt(handle, CURLOPT_CUSTOMREQUEST, "GET"); // Keep GET when a body is attached
+            } else {
+                curl_easy_setopt(handle, CURLOPT_HTTPGET, 1L);
             }
-            
-            // Add form fields
-            for (const auto& field_pair : request.params_.get()) {
-                curl_mimepart* part = curl_mime_addpart(mime);
-                if (!part) continue;
-                
-                curl_mime_name(part, field_pair.first.c_str());
-                curl_mime_data(part, field_pair.second.c_str(), CURL_ZERO_TERMINATED);
+            break;
+        case METHOD::Verb::POST:
+            curl_easy_setopt(handle, CURLOPT_POST, 1L);
+            if (!has_body) {
+                // Without POSTFIELDS libcurl would read the body from stdin
+                curl_easy_setopt(handle, CURLOPT_POSTFIELDS, "");
+                curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE, 0L);
             }
-            
-            curl_easy_setopt(handle, CURLOPT_MIMEPOST, mime);
-        } else if (!request.body_.toString().empty()) {
-            curl_easy_setopt(handle, CURLOPT_POSTFIELDS, request.body_.c_str());
-            curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE, request.body_.length());
+            break;
+        case METHOD::Verb::HEAD:
+            curl_easy_setopt(handle, CURLOPT_NOBODY, 1L);
+            break;
+        default:
+            curl_easy_setopt(handle, CURLOPT_CUSTOMREQUEST, request.get_method().c_str());
+            break;
+    }
+    
+    // Handle file uploads
+    if (!request.files_.get().empty()) {
+        transfer.mime.reset(curl_mime_init(handle));
+        if (!transfer.mime) {
+            return setup_error(CURLE_OUT_OF_MEMORY, detail, "Failed to initialize MIME structure");
         }
         
-        // Handle output
-        if (!request.output_file_path_.empty()) {
-            output_file = fopen(request.output_file_path_.c_str(), "wb");
-            if (!output_file) {
-                throw RequestException("Failed to open output file: " + request.output_file_path_);
-            }
-            curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, safe_file_write_callback);
-            curl_easy_setopt(handle, CURLOPT_WRITEDATA, output_file);
-        } else if (request.method_.value == "HEAD") {
-            curl_easy_setopt(handle, CURLOPT_NOBODY, 1L);
-            curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, nullptr);
-            curl_easy_setopt(handle, CURLOPT_WRITEDATA, nullptr);
-        } else {
-            curl_easy_setopt(handle, CURLOPT_NOBODY, 0L);
-            curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, safe_write_callback);
-            curl_easy_setopt(handle, CURLOPT_WRITEDATA, &response_body);
+        for (const auto& file_pair : request.files_.get()) {
+            curl_mimepart* part = curl_mime_addpart(transfer.mime.get());
+            if (!part) continue;
+            
+            curl_mime_name(part, file_pair.first.c_str());
+            curl_mime_filedata(part, file_pair.second.c_str());
         }
         
-        // Set headers
-        curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, safe_header_callback);
-        curl_easy_setopt(handle, CURLOPT_HEADERDATA, &response_headers);
+        // Add form fields
+        for (const auto& [name, value] : request.params_) {
+            curl_mimepart* part = curl_mime_addpart(transfer.mime.get());
+            if (!part) continue;
+            
+            curl_mime_name(part, name.data()); // PARAMS keeps keys NUL-terminated
+            curl_mime_data(part, value.data(), value.size());
+        }
         
-        // Merge headers
-        HEADERS effective_headers = default_headers_;
-        for (const auto& header_line : request.headers_.all()) {
+        curl_easy_setopt(handle, CURLOPT_MIMEPOST, transfer.mime.get());
+    } else if (!request.body_.toString().empty()) {
+        curl_easy_setopt(handle, CURLOPT_POSTFIELDS, request.body_.c_str());
+        curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE, request.body_.length());
+    }
+    
+    // Handle output
+    if (!request.output_file_path_.empty()) {
+        transfer.output_file.reset(std::fopen(request.output_file_path_.c_str(), "wb"));
+        if (!transfer.output_file) {
+            return setup_error(CURLE_WRITE_ERROR, detail, "Failed to open output file: " + request.output_file_path_);
+        }
+        curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, safe_file_write_callback);
+        curl_easy_setopt(handle, CURLOPT_WRITEDATA, transfer.output_file.get());
+    } else if (request.method_.verb() == METHOD::Verb::HEAD) {
+        curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, nullptr);
+        curl_easy_setopt(handle, CURLOPT_WRITEDATA, nullptr);
+    } else {
+        curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, &safe_write_callback<Policy>);
+        curl_easy_setopt(handle, CURLOPT_WRITEDATA, &transfer.response_body);
+    }
+    
+    // Set headers
+    curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, &safe_header_callback<Policy>);
+    curl_easy_setopt(handle, CURLOPT_HEADERDATA, &transfer.header_sink);
+    
+    // Merge headers
+    HEADERS& effective_headers = transfer.effective_headers;
+    for (const auto& header_line : request.headers_.all()) {
+        if constexpr (Policy::validate_headers) {
             effective_headers.add(header_line);
+        } else {
+            effective_headers.add_unchecked(header_line); // Already validated when it was added
         }
-        
-        struct curl_slist* chunk = effective_headers.to_curl_slist();
-        if (chunk) {
-            curl_easy_setopt(handle, CURLOPT_HTTPHEADER, chunk);
+    }
+    
+    transfer.header_list.reset(effective_headers.to_curl_slist());
+    if (transfer.header_list) {
+        curl_easy_setopt(handle, CURLOPT_HTTPHEADER, transfer.header_list.get());
+    }
+    
+    // Handle cookies
+    COOKIES effective_cookies(default_cookies_, transient);
+    for (const auto& cookie_pair : request.cookies_.all()) {
+        effective_cookies.add(cookie_pair.first, cookie_pair.second);
+    }
+    
+    std::pmr::string cookie_string(transient);
+    for (const auto& cookie_pair : effective_cookies.all()) {
+        cookie_string.assign(cookie_pair.first);
+        cookie_string += '=';
+        cookie_string += cookie_pair.second;
+        curl_easy_setopt(handle, CURLOPT_COOKIELIST, cookie_string.c_str());
+    }
+    
+    // Handle authentication
+    if (request.auth_.type() != AuthType::None) {
+        curl_easy_setopt(handle, CURLOPT_USERPWD, request.auth_.user_pass_string().c_str());
+        if (request.auth_.type() == AuthType::Basic) {
+            curl_easy_setopt(handle, CURLOPT_HTTPAUTH, CURLAUTH_BASIC);
+        } else if (request.auth_.type() == AuthType::Digest) {
+            curl_easy_setopt(handle, CURLOPT_HTTPAUTH, CURLAUTH_DIGEST);
         }
-        
-        // Handle cookies
-        COOKIES effective_cookies = default_cookies_;
-        for (const auto& cookie_pair : request.cookies_.all()) {
-            effective_cookies.add(cookie_pair.first, cookie_pair.second);
+    }
+    
+    // Handle redirects
+    if (request.allow_redirects_.allow()) {
+        curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1L);
+        curl_easy_setopt(handle, CURLOPT_MAXREDIRS, request.allow_redirects_.getMaxRedirects());
+    } else {
+        curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 0L);
+    }
+    
+#if defined(CURLX_HAVE_USDT) && LIBCURL_VERSION_NUM >= 0x075000 // 7.80.0: CURLOPT_PREREQFUNCTION
+    // Only pay for the callback and its getinfo calls while someone is tracing
+    if (CURLX_PROBE_ENABLED(dns__done) || CURLX_PROBE_ENABLED(connect)) {
+        curl_easy_setopt(handle, CURLOPT_PREREQFUNCTION, &probe_connected);
+        curl_easy_setopt(handle, CURLOPT_PREREQDATA, &transfer.header_sink);
+    }
+#endif
+    CURLX_PROBE(request__start, transfer.id, request.get_method().c_str(), request.get_url().c_str());
+    
+    // Tail-sampled debug capture: record everything, decide in finish_transfer
+    if (debug_capture_) {
+        transfer.debug.emplace(debug_capture_, transient);
+        curl_easy_setopt(handle, CURLOPT_DEBUGFUNCTION, &DebugRecorder::callback);
+        curl_easy_setopt(handle, CURLOPT_DEBUGDATA, &*transfer.debug);
+        curl_easy_setopt(handle, CURLOPT_VERBOSE, 1L);
+    }
+    
+    stall.start();
+    return std::nullopt;
+}
+
+// Build the response, or the error, once libcurl is done with the transfer
+template<typename Policy>
+std::expected<RESPONSE, Error> BasicSession<Policy>::finish_transfer(Transfer& transfer, CURLcode res, std::string* detail) {
+    const auto cpu_start = transfer.account_cpu ? thread_cpu_time() : std::chrono::nanoseconds(0);
+    auto result = build_response(transfer, res, detail);
+    if (transfer.debug) {
+        curl_off_t total = 0;
+        curl_easy_getinfo(transfer.handle, CURLINFO_TOTAL_TIME_T, &total);
+        transfer.pending_trace = transfer.debug->finish(
+            transfer.request.get_method().name(), transfer.request.get_url().toString(),
+            result ? CURLE_OK : result.error().code, result ? result->statusCode : 0, std::chrono::microseconds(total));
+        if (result) {
+            result->debug_trace = transfer.pending_trace.trace;
         }
-        
-        for (const auto& cookie_pair : effective_cookies.all()) {
-            std::string cookie_string = cookie_pair.first + "=" + cookie_pair.second;
-            curl_easy_setopt(handle, CURLOPT_COOKIELIST, cookie_string.c_str());
+    }
+    if (transfer.account_cpu) {
+        transfer.cpu.post = thread_cpu_time() - cpu_start;
+        if (result) {
+            result->cpu_time = transfer.cpu;
         }
+    }
+#ifdef CURLX_HAVE_USDT
+    if (result) {
+        CURLX_PROBE(request__done, transfer.id, result->statusCode, result->timings.total.count(), result->traffic.received());
+    } else {
+        CURLX_PROBE(request__error, transfer.id, static_cast<int>(result.error().code), static_cast<int>(result.error().phase));
+    }
+#endif
+    return result;
+}
+
+template<typename Policy>
+void BasicSession<Policy>::deliver_debug_trace(Transfer& transfer) noexcept {
+    transfer.pending_trace.deliver();
+}
+
+template<typename Policy>
+std::expected<RESPONSE, Error> BasicSession<Policy>::build_response(Transfer& transfer, CURLcode res, std::string* detail) {
+    CURL* handle = transfer.handle;
+    const REQUEST& request = transfer.request;
+    
+    if (res == CURLE_OK) {
+        RESPONSE response;
         
-        // Handle authentication
-        if (request.auth_.type() != AuthType::None) {
-            curl_easy_setopt(handle, CURLOPT_USERPWD, request.auth_.user_pass_string().c_str());
-            if (request.auth_.type() == AuthType::Basic) {
-                curl_easy_setopt(handle, CURLOPT_HTTPAUTH, CURLAUTH_BASIC);
-            } else if (request.auth_.type() == AuthType::Digest) {
-                curl_easy_setopt(handle, CURLOPT_HTTPAUTH, CURLAUTH_DIGEST);
-            }
-        }
+        // Get response information
+        long response_code = 0;
+        curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &response_code);
         
-        // Handle redirects
-        if (request.allow_redirects_.allow()) {
-            curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1L);
-            curl_easy_setopt(handle, CURLOPT_MAXREDIRS, request.allow_redirects_.getMaxRedirects());
-        } else {
-            curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 0L);
-        }
+        response.statusCode = response_code;
+        response.body = transfer.response_body.finish();
+        response.headers = transfer.response_headers; // Copy out of the arena
+        response.request_url = request.url_;
+        response.request_headers = transfer.effective_headers;
         
-        // Execute request
-        res = curl_easy_perform(handle);
+        // Get timing information
+        response.timings = read_timings(handle);
+        response.elapsed_time = std::chrono::duration<double>(response.timings.total).count();
+        response.traffic = transfer_traffic(transfer);
         
-        if (res == CURLE_OK) {
-            // Get response information
-            long response_code = 0;
-            curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &response_code);
-            
-            response.statusCode = response_code;
-            response.body = response_body;
-            response.headers = response_headers;
-            response.request_url = request.url_;
-            response.request_headers = effective_headers;
-            
-            // Get timing information
-            double total_time = 0.0;
-            curl_easy_getinfo(handle, CURLINFO_TOTAL_TIME, &total_time);
-            response.elapsed_time = total_time;
-            
-            // Parse received cookies
-            for (const auto& header_line : response_headers.all()) {
-                if (header_line.rfind("Set-Cookie:", 0) == 0) {
-                    std::string cookie_str = header_line.substr(12); // Skip "Set-Cookie: "
-                    size_t eq_pos = cookie_str.find('=');
-                    if (eq_pos != std::string::npos) {
-                        std::string cookie_name = cookie_str.substr(0, eq_pos);
-                        size_t semicolon_pos = cookie_str.find(';', eq_pos);
-                        std::string cookie_value = cookie_str.substr(eq_pos + 1, 
-                            semicolon_pos != std::string::npos ? semicolon_pos - (eq_pos + 1) : std::string::npos);
-                        response.received_cookies.add(cookie_name, cookie_value);
-                    }
-                }
-            }
-            
-            // Build redirect history
-            long redirect_count = 0;
-            curl_easy_getinfo(handle, CURLINFO_REDIRECT_COUNT, &redirect_count);
-            if (redirect_count > 0) {
-                char* effective_url_cstr = nullptr;
-                curl_easy_getinfo(handle, CURLINFO_EFFECTIVE_URL, &effective_url_cstr);
-                if (effective_url_cstr) {
-                    response.history.push_back(URL(effective_url_cstr));
+        // Parse received cookies
+        for (const auto& header_line : response.headers.all()) {
+            if (header_line.rfind("Set-Cookie:", 0) == 0) {
+                const std::string_view cookie_str = std::string_view(header_line).substr(12); // Skip "Set-Cookie: "
+                size_t eq_pos = cookie_str.find('=');
+                if (eq_pos != std::string::npos) {
+                    const std::string_view cookie_name = cookie_str.substr(0, eq_pos);
+                    size_t semicolon_pos = cookie_str.find(';', eq_pos);
+                    const std::string_view cookie_value = cookie_str.substr(eq_pos + 1, 
+                        semicolon_pos != std::string::npos ? semicolon_pos - (eq_pos + 1) : std::string::npos);
+                    response.received_cookies.add(cookie_name, cookie_value);
                 }
             }
-            
-            // Update statistics
-            const auto end_time = std::chrono::high_resolution_clock::now();
-            const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
-            update_statistics(duration.count() / 1000000.0);
-            
-        } else {
-            // Handle CURL errors
-            std::string error_message = curl_easy_strerror(res);
-            switch (res) {
-                case CURLE_COULDNT_CONNECT:
-                case CURLE_COULDNT_RESOLVE_HOST:
-                    throw ConnectionError(error_message);
-                case CURLE_OPERATION_TIMEDOUT:
-                    throw Timeout(error_message);
-                case CURLE_TOO_MANY_REDIRECTS:
-                    throw TooManyRedirects(error_message);
-                default:
-                    throw RequestException(error_message);
-            }
         }
         
-        // Cleanup
-        if (chunk) curl_slist_free_all(chunk);
-        if (mime) curl_mime_free(mime);
-        if (output_file) fclose(output_file);
+        // Build redirect history
+        long redirect_count = 0;
+        curl_easy_getinfo(handle, CURLINFO_REDIRECT_COUNT, &redirect_count);
+        if (redirect_count > 0) {
+            char* effective_url_cstr = nullptr;
+            curl_easy_getinfo(handle, CURLINFO_EFFECTIVE_URL, &effective_url_cstr);
+            if (effective_url_cstr) {
+                response.history.push_back(URL(effective_url_cstr));
+            }
+        }
         
         return response;
-        
-    } catch (const std::exception& e) {
-        // Update statistics even on failure
-        const auto end_time = std::chrono::high_resolution_clock::now();
-        const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
-        update_statistics(duration.count() / 1000000.0);
-        throw;
     }
+    
+    // Handle CURL errors: a compact code, with the message built only for the throwing API
+    const BodySink& response_body = transfer.response_body;
+    if (response_body.limit_exceeded || res == CURLE_FILESIZE_EXCEEDED) {
+        if (detail) {
+            *detail = "Response body exceeds the configured limit of " +
+                      std::to_string(transfer.limits.max_body_size) + " bytes";
+        }
+        return std::unexpected(Error{CURLE_FILESIZE_EXCEEDED, Error::Phase::Body});
+    }
+    if (!response_body.error.empty()) {
+        if (detail) {
+            *detail = "Failed to store response body: " + response_body.error;
+        }
+        return std::unexpected(Error{CURLE_WRITE_ERROR, Error::Phase::Body});
+    }
+    if (res == CURLE_ABORTED_BY_CALLBACK && request.get_stop_token().stop_requested()) {
+        if (detail) {
+            *detail = "Request was cancelled";
+        }
+        return std::unexpected(Error{res, transfer_phase(handle, res)});
+    }
+    const StallMonitor& stall = transfer.stall;
+    if (stall.stalled) {
+        if (detail) {
+            *detail = "Transfer stalled: fewer than " + std::to_string(stall.min_bytes_per_second) +
+                      " bytes/s over " + std::to_string(stall.window.count()) + " ms";
+        }
+        return std::unexpected(Error{CURLE_OPERATION_TIMEDOUT, transfer_phase(handle, res)});
+    }
+    return std::unexpected(Error{res, transfer_phase(handle, res)});
+}
+
+// Runs the transfer on the session's multi handle, so a stop request can wake
+// the poll and remove the transfer at once instead of waiting for the next
+// progress callback. Removing an unfinished transfer closes its connection.
+template<typename Policy>
+CURLcode BasicSession<Policy>::perform_cancellable(CURL* handle, const std::stop_token& token) {
+    if (!multi_handle_) {
+        CURLM* multi = curl_multi_init();
+        if (!multi) {
+            return CURLE_OUT_OF_MEMORY;
+        }
+        multi_handle_ = std::unique_ptr<CURLM, CurlMultiDeleter>(multi);
+        curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(max_connections_per_host_));
+    }
+    CURLM* multi = multi_handle_.get();
+    if (curl_multi_add_handle(multi, handle) != CURLM_OK) {
+        return CURLE_FAILED_INIT;
+    }
+    
+    std::stop_callback wake(token, [multi] { curl_multi_wakeup(multi); });
+    CURLcode result = CURLE_OK;
+    int running = 1;
+    while (true) {
+        if (token.stop_requested()) {
+            result = CURLE_ABORTED_BY_CALLBACK;
+            break;
+        }
+        if (curl_multi_perform(multi, &running) != CURLM_OK) {
+            result = CURLE_FAILED_INIT;
+            break;
+        }
+        if (running == 0) {
+            int queued = 0;
+            const CURLMsg* message = curl_multi_info_read(multi, &queued);
+            result = (message && message->msg == CURLMSG_DONE) ? message->data.result : CURLE_FAILED_INIT;
+            break;
+        }
+        curl_multi_poll(multi, nullptr, 0, 1000, nullptr);
+    }
+    
+    curl_multi_remove_handle(multi, handle);
+    return result;
 }
 
-std::future<CurlX::RESPONSE> Session::send_async(const REQUEST& request) {
+template<typename Policy>
+std::future<CurlX::RESPONSE> BasicSession<Policy>::send_async(const REQUEST& request) {
     return std::async(std::launch::async, [this, request]() {
         return this->send(request);
     });
 }
 
 // HTTP verb implementations
-RESPONSE Session::GET(const URL& url, const PARAMS& params, const HEADERS& headers, 
+template<typename Policy>
+RESPONSE BasicSession<Policy>::GET(const URL& url, const PARAMS& params, const HEADERS& headers, 
                       const COOKIES& cookies, const TIMEOUT& timeout, const AUTH& auth, 
                       const PROXY& proxy, const REDIRECTS& redirects, const VERIFY& verify) {
     REQUEST request(url, METHOD::GET, headers, BODY(), timeout, auth, proxy, cookies, redirects, verify, params);
     return send(request);
 }
 
-RESPONSE Session::POST(const URL& url, const BODY& body, const HEADERS& headers, 
+template<typename Policy>
+RESPONSE BasicSession<Policy>::POST(const URL& url, const BODY& body, const HEADERS& headers, 
                        const COOKIES& cookies, const TIMEOUT& timeout, const AUTH& auth, 
                        const PROXY& proxy, const REDIRECTS& redirects, const VERIFY& verify, 
                        const FILES& files, const PARAMS& params) {
@@ -573,35 +1224,40 @@ RESPONSE Session::POST(const URL& url, const BODY& body, const HEADERS& headers,
     return send(request);
 }
 
-RESPONSE Session::PUT(const URL& url, const BODY& body, const HEADERS& headers, 
+template<typename Policy>
+RESPONSE BasicSession<Policy>::PUT(const URL& url, const BODY& body, const HEADERS& headers, 
                       const COOKIES& cookies, const TIMEOUT& timeout, const AUTH& auth, 
                       const PROXY& proxy, const REDIRECTS& redirects, const VERIFY& verify) {
     REQUEST request(url, METHOD::PUT, headers, body, timeout, auth, proxy, cookies, redirects, verify);
     return send(request);
 }
 
-RESPONSE Session::DELETE(const URL& url, const HEADERS& headers, const COOKIES& cookies, 
+template<typename Policy>
+RESPONSE BasicSession<Policy>::DELETE(const URL& url, const HEADERS& headers, const COOKIES& cookies, 
                          const TIMEOUT& timeout, const AUTH& auth, const PROXY& proxy, 
                          const REDIRECTS& redirects, const VERIFY& verify) {
     REQUEST request(url, METHOD::DELETE, headers, BODY(), timeout, auth, proxy, cookies, redirects, verify);
     return send(request);
 }
 
-RESPONSE Session::PATCH(const URL& url, const BODY& body, const HEADERS& headers, 
+template<typename Policy>
+RESPONSE BasicSession<Policy>::PATCH(const URL& url, const BODY& body, const HEADERS& headers, 
                         const COOKIES& cookies, const TIMEOUT& timeout, const AUTH& auth, 
                         const PROXY& proxy, const REDIRECTS& redirects, const VERIFY& verify) {
     REQUEST request(url, METHOD::PATCH, headers, body, timeout, auth, proxy, cookies, redirects, verify);
     return send(request);
 }
 
-RESPONSE Session::HEAD(const URL& url, const HEADERS& headers, const COOKIES& cookies, 
+template<typename Policy>
+RESPONSE BasicSession<Policy>::HEAD(const URL& url, const HEADERS& headers, const COOKIES& cookies, 
                        const TIMEOUT& timeout, const AUTH& auth, const PROXY& proxy, 
                        const REDIRECTS& redirects, const VERIFY& verify) {
     REQUEST request(url, METHOD::HEAD, headers, BODY(), timeout, auth, proxy, cookies, redirects, verify);
     return send(request);
 }
 
-RESPONSE Session::OPTIONS(const URL& url, const HEADERS& headers, const COOKIES& cookies, 
+template<typename Policy>
+RESPONSE BasicSession<Policy>::OPTIONS(const URL& url, const HEADERS& headers, const COOKIES& cookies, 
                           const TIMEOUT& timeout, const AUTH& auth, const PROXY& proxy, 
                           const REDIRECTS& redirects, const VERIFY& verify) {
     REQUEST request(url, METHOD::OPTIONS, headers, BODY(), timeout, auth, proxy, cookies, redirects, verify);
@@ -609,17 +1265,20 @@ RESPONSE Session::OPTIONS(const URL& url, const HEADERS& headers, const COOKIES&
 }
 
 // Configuration methods
-void Session::set_default_headers(const HEADERS& headers) {
+template<typename Policy>
+void BasicSession<Policy>::set_default_headers(const HEADERS& headers) {
     std::lock_guard<std::mutex> lock(session_mutex_);
     default_headers_ = headers;
 }
 
-void Session::set_default_cookies(const COOKIES& cookies) {
+template<typename Policy>
+void BasicSession<Policy>::set_default_cookies(const COOKIES& cookies) {
     std::lock_guard<std::mutex> lock(session_mutex_);
     default_cookies_ = cookies;
 }
 
-void Session::set_cookie_jar(const std::string& file_path) {
+template<typename Policy>
+void BasicSession<Policy>::set_cookie_jar(const std::string& file_path) {
     std::lock_guard<std::mutex> lock(session_mutex_);
     cookie_jar_path_ = file_path;
     if (curl_handle_) {
@@ -629,73 +1288,148 @@ void Session::set_cookie_jar(const std::string& file_path) {
 }
 
 // Performance tuning methods
-void Session::set_connection_timeout(double seconds) {
+template<typename Policy>
+void BasicSession<Policy>::set_connection_timeout(double seconds) {
     if (seconds < 0.0) seconds = 0.0;
     connection_timeout_ = seconds;
     if (curl_handle_) {
-        curl_easy_setopt(curl_handle_.get(), CURLOPT_CONNECTTIMEOUT, static_cast<long>(seconds));
+        curl_easy_setopt(curl_handle_.get(), CURLOPT_CONNECTTIMEOUT_MS, to_milliseconds(seconds));
     }
 }
 
-void Session::set_transfer_timeout(double seconds) {
+template<typename Policy>
+void BasicSession<Policy>::set_transfer_timeout(double seconds) {
     if (seconds < 0.0) seconds = 0.0;
     transfer_timeout_ = seconds;
     if (curl_handle_) {
-        curl_easy_setopt(curl_handle_.get(), CURLOPT_TIMEOUT, static_cast<long>(seconds));
+        curl_easy_setopt(curl_handle_.get(), CURLOPT_TIMEOUT_MS, to_milliseconds(seconds));
     }
 }
 
-void Session::set_max_connections_per_host(size_t max_conns) {
+template<typename Policy>
+void BasicSession<Policy>::set_stall_detection(size_t min_bytes_per_second, std::chrono::milliseconds window) {
+    std::lock_guard<std::mutex> lock(session_mutex_);
+    stall_min_bytes_per_second_ = min_bytes_per_second;
+    stall_window_ = window;
+}
+
+template<typename Policy>
+void BasicSession<Policy>::set_max_connections_per_host(size_t max_conns) {
+    std::lock_guard<std::mutex> lock(session_mutex_);
     max_connections_per_host_ = max_conns;
+    if (multi_handle_) {
+        curl_multi_setopt(multi_handle_.get(), CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(max_conns));
+    }
+}
+
+template<typename Policy>
+void BasicSession<Policy>::set_connection_cache_size(size_t connections) {
+    std::lock_guard<std::mutex> lock(session_mutex_);
+    connection_cache_size_ = connections;
     if (curl_handle_) {
-        curl_easy_setopt(curl_handle_.get(), CURLOPT_MAXCONNECTS, static_cast<long>(max_conns));
+        curl_easy_setopt(curl_handle_.get(), CURLOPT_MAXCONNECTS, static_cast<long>(connections));
     }
 }
 
-void Session::set_keep_alive(bool enable) {
+template<typename Policy>
+void BasicSession<Policy>::set_keep_alive(bool enable) {
     keep_alive_enabled_ = enable;
     if (curl_handle_) {
         curl_easy_setopt(curl_handle_.get(), CURLOPT_TCP_KEEPALIVE, enable ? 1L : 0L);
     }
 }
 
-void Session::set_compression(bool enable) {
+template<typename Policy>
+void BasicSession<Policy>::set_compression(bool enable) {
     compression_enabled_ = enable;
     if (curl_handle_) {
         curl_easy_setopt(curl_handle_.get(), CURLOPT_ACCEPT_ENCODING, enable ? "gzip,deflate" : "");
     }
 }
 
+template<typename Policy>
+void BasicSession<Policy>::set_body_storage(BodyStorage storage) {
+    std::lock_guard<std::mutex> lock(session_mutex_);
+    body_storage_ = storage;
+}
+
+template<typename Policy>
+void BasicSession<Policy>::set_request_arena(bool enable) {
+    std::lock_guard<std::mutex> lock(session_mutex_);
+    request_arena_enabled_ = enable;
+}
+
+template<typename Policy>
+void BasicSession<Policy>::set_limits(const LIMITS& limits) {
+    std::lock_guard<std::mutex> lock(session_mutex_);
+    limits_ = limits;
+    if (curl_handle_) {
+        curl_easy_setopt(curl_handle_.get(), CURLOPT_MAXFILESIZE_LARGE, static_cast<curl_off_t>(limits_.max_body_size));
+    }
+}
+
+template<typename Policy>
+const LIMITS& BasicSession<Policy>::get_limits() const noexcept {
+    return limits_;
+}
+
+template<typename Policy>
+void BasicSession<Policy>::set_memory_budget(std::shared_ptr<MemoryBudget> budget) {
+    std::lock_guard<std::mutex> lock(session_mutex_);
+    if (memory_budget_) {
+        memory_budget_->unregister_session();
+    }
+    memory_budget_ = std::move(budget);
+    if (memory_budget_) {
+        memory_budget_->register_session();
+    }
+}
+
+template<typename Policy>
+std::shared_ptr<MemoryBudget> BasicSession<Policy>::get_memory_budget() const {
+    std::lock_guard<std::mutex> lock(session_mutex_);
+    return memory_budget_;
+}
+
 // Safety and monitoring methods
-bool Session::is_valid() const noexcept {
+template<typename Policy>
+bool BasicSession<Policy>::is_valid() const noexcept {
     return is_valid_.load() && curl_handle_ != nullptr;
 }
 
-void Session::reset() noexcept {
+template<typename Policy>
+void BasicSession<Policy>::reset() noexcept {
     std::lock_guard<std::mutex> lock(session_mutex_);
     if (curl_handle_) {
         curl_easy_reset(curl_handle_.get());
-        apply_safety_settings();
-        apply_performance_settings();
+        apply_safety_settings(curl_handle_.get());
+        apply_performance_settings(curl_handle_.get());
     }
 }
 
-size_t Session::get_request_count() const noexcept {
-    return request_count_.load();
+template<typename Policy>
+size_t BasicSession<Policy>::get_request_count() const noexcept {
+    return counters_.requests();
+}
+
+template<typename Policy>
+double BasicSession<Policy>::get_average_response_time() const noexcept {
+    return counters_.read().average_response_time();
 }
 
-double Session::get_average_response_time() const noexcept {
-    std::lock_guard<std::mutex> lock(stats_mutex_);
-    size_t count = request_count_.load();
-    return count > 0 ? total_response_time_.load() / count : 0.0;
+template<typename Policy>
+STATISTICS BasicSession<Policy>::get_statistics() const noexcept {
+    return counters_.read();
 }
 
 // Connection pooling
-void Session::enable_connection_pooling(bool enable) {
+template<typename Policy>
+void BasicSession<Policy>::enable_connection_pooling(bool enable) {
     pooling_enabled_ = enable;
 }
 
-void Session::set_pool_size(size_t size) {
+template<typename Policy>
+void BasicSession<Policy>::set_pool_size(size_t size) {
     (void)size; // Suppress unused parameter warning
     if (connection_pool_) {
         // Note: This would require a more sophisticated pool implementation
@@ -703,28 +1437,113 @@ void Session::set_pool_size(size_t size) {
     }
 }
 
-CURL* Session::get_curl_handle() const noexcept {
+template<typename Policy>
+CURL* BasicSession<Policy>::get_curl_handle() const noexcept {
     return curl_handle_ ? curl_handle_.get() : nullptr;
 }
 
+template<typename Policy>
+const LatencyStats& BasicSession<Policy>::get_latency_stats() const noexcept {
+    return latency_stats_;
+}
+
+template<typename Policy>
+const TrafficStats& BasicSession<Policy>::get_traffic_stats() const noexcept {
+    return traffic_stats_;
+}
+
+template<typename Policy>
+const ConnectionStats& BasicSession<Policy>::get_connection_stats() const noexcept {
+    return connection_stats_;
+}
+
+template<typename Policy>
+void BasicSession<Policy>::set_debug_capture(std::optional<DEBUG_CAPTURE> capture) {
+    std::lock_guard<std::mutex> lock(session_mutex_);
+    if (capture) {
+        debug_capture_ = std::make_shared<const DEBUG_CAPTURE>(std::move(*capture));
+    } else {
+        debug_capture_.reset();
+    }
+}
+
+template<typename Policy>
+void BasicSession<Policy>::set_cpu_accounting(bool enable) {
+    std::lock_guard<std::mutex> lock(session_mutex_);
+    cpu_accounting_ = enable;
+}
+
+// Only meaningful once the transfer ran: libcurl keeps the previous request's counts until then
+template<typename Policy>
+TRAFFIC BasicSession<Policy>::transfer_traffic(const Transfer& transfer) const {
+    const auto info = [handle = transfer.handle](CURLINFO what) -> uint64_t {
+        curl_off_t value = 0;
+        curl_easy_getinfo(handle, what, &value);
+        return value > 0 ? static_cast<uint64_t>(value) : 0;
+    };
+    long request_size = 0;
+    long header_size = 0;
+    curl_easy_getinfo(transfer.handle, CURLINFO_REQUEST_SIZE, &request_size);
+    curl_easy_getinfo(transfer.handle, CURLINFO_HEADER_SIZE, &header_size);
+    
+    TRAFFIC traffic;
+    traffic.request_body = info(CURLINFO_SIZE_UPLOAD_T);
+    traffic.request_headers = static_cast<uint64_t>(std::max(request_size, 0L));
+    traffic.request_headers -= std::min(traffic.request_headers, traffic.request_body); // REQUEST_SIZE counts the body too
+    traffic.response_headers = static_cast<uint64_t>(std::max(header_size, 0L));
+    traffic.wire_body = info(CURLINFO_SIZE_DOWNLOAD_T);
+    if (transfer.output_file) {
+        const long written = std::ftell(transfer.output_file.get());
+        traffic.decoded_body = written > 0 ? static_cast<uint64_t>(written) : 0;
+    } else {
+        traffic.decoded_body = transfer.response_body.received;
+    }
+    return traffic;
+}
+
 // Private helper methods
-void Session::update_statistics(double response_time) {
-    request_count_.fetch_add(1);
-    total_response_time_.fetch_add(response_time);
+template<typename Policy>
+void BasicSession<Policy>::update_statistics(const REQUEST& request, const Transfer* transfer, CURLcode result, long status,
+                                             std::chrono::microseconds elapsed) {
+    const TRAFFIC traffic = transfer ? transfer_traffic(*transfer) : TRAFFIC{};
+    counters_.record(result, traffic.sent(), traffic.received(), elapsed, transfer ? transfer->cpu : CPU_TIME{});
+
+    // Requests with an unparsable URL are grouped under an empty host
+    const auto parsed = request.get_url().try_parsed();
+    const std::string_view host = parsed ? (*parsed)->host_key() : std::string_view();
+    latency_stats_.record(host, request.get_method().name(), status, elapsed);
+    traffic_stats_.record(host, traffic);
+    if (transfer) {
+        long new_connections = 0;
+        curl_easy_getinfo(transfer->handle, CURLINFO_NUM_CONNECTS, &new_connections);
+        connection_stats_.record_request(host, new_connections == 0);
+    }
 }
 
 // CurlHandleDeleter implementation
-void Session::CurlHandleDeleter::operator()(CURL* handle) const noexcept {
+template<typename Policy>
+void BasicSession<Policy>::CurlHandleDeleter::operator()(CURL* handle) const noexcept {
     if (handle) {
         curl_easy_cleanup(handle);
     }
 }
 
+template<typename Policy>
+void BasicSession<Policy>::CurlMultiDeleter::operator()(CURLM* multi) const noexcept {
+    if (multi) {
+        curl_multi_cleanup(multi);
+    }
+}
+
 // Template method implementation
+template<typename Policy>
 template<typename Func>
-auto Session::with_lock(Func&& func) const -> decltype(func()) {
+auto BasicSession<Policy>::with_lock(Func&& func) const -> decltype(func()) {
     std::lock_guard<std::mutex> lock(session_mutex_);
     return func();
 }
 
+template class BasicSession<DefaultPolicy>;
+template class BasicSession<TrustedPolicy>;
+
 } // namespace CurlX
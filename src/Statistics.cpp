@@ -0,0 +1,255 @@
+#include "CurlX/Statistics.hpp"
+#include <algorithm>
+#include <bit>
+#include <thread>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace CurlX {
+
+size_t counter_shards() noexcept {
+    static const size_t shards = std::bit_ceil(std::clamp<size_t>(std::thread::hardware_concurrency(), 1, 64));
+    return shards;
+}
+
+SessionCounters::SessionCounters() : shards_(std::make_unique<Shard[]>(counter_shards())), mask_(counter_shards() - 1) {}
+
+STATISTICS SessionCounters::read() const noexcept {
+    STATISTICS stats;
+    if (!shards_) {
+        return stats;
+    }
+    uint64_t micros = 0;
+    for (size_t i = 0; i <= mask_; ++i) {
+        const Shard& shard = shards_[i];
+        stats.requests += shard.requests.load(std::memory_order_relaxed);
+        stats.bytes_sent += shard.bytes_sent.load(std::memory_order_relaxed);
+        stats.bytes_received += shard.bytes_received.load(std::memory_order_relaxed);
+        micros += shard.micros.load(std::memory_order_relaxed);
+        stats.cpu_time.setup += std::chrono::nanoseconds(shard.cpu_setup.load(std::memory_order_relaxed));
+        stats.cpu_time.callbacks += std::chrono::nanoseconds(shard.cpu_callbacks.load(std::memory_order_relaxed));
+        stats.cpu_time.post += std::chrono::nanoseconds(shard.cpu_post.load(std::memory_order_relaxed));
+        stats.cpu_time.libcurl += std::chrono::nanoseconds(shard.cpu_libcurl.load(std::memory_order_relaxed));
+        for (size_t code = 0; code < CURL_LAST; ++code) {
+            stats.errors[code] += shard.errors[code].load(std::memory_order_relaxed);
+        }
+    }
+    for (const uint64_t count : stats.errors) {
+        stats.failures += count;
+    }
+    stats.total_time = std::chrono::microseconds(static_cast<std::chrono::microseconds::rep>(micros));
+    return stats;
+}
+
+uint64_t SessionCounters::requests() const noexcept {
+    uint64_t total = 0;
+    for (size_t i = 0; shards_ && i <= mask_; ++i) {
+        total += shards_[i].requests.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+std::string_view HostLimit::admit(std::string_view host) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        if (hosts_.contains(host)) {
+            return host;
+        }
+        if (hosts_.size() >= max_hosts_) {
+            return OTHER_HOST;
+        }
+    }
+    std::lock_guard<std::shared_mutex> lock(mutex_);
+    if (hosts_.size() >= max_hosts_ && !hosts_.contains(host)) {
+        return OTHER_HOST;
+    }
+    hosts_.emplace(host);
+    return host;
+}
+
+TrafficStats::TrafficStats(size_t max_hosts)
+    : shards_(std::make_unique<Shard[]>(counter_shards()))
+    , mask_(counter_shards() - 1)
+    , limit_(std::make_unique<HostLimit>(max_hosts)) {}
+
+void TrafficStats::record(std::string_view host, const TRAFFIC& traffic) {
+    if (!shards_) {
+        return; // Moved from
+    }
+    Shard& shard = shards_[thread_slot() & mask_];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.hosts.find(host);
+    if (it == shard.hosts.end()) {
+        host = limit_->admit(host);
+        it = shard.hosts.find(host);
+    }
+    if (it == shard.hosts.end()) {
+        it = shard.hosts.emplace(std::string(host), Host{std::string(host), 0, {}}).first;
+    }
+    ++it->second.requests;
+    it->second.traffic += traffic;
+}
+
+std::vector<TrafficStats::Host> TrafficStats::snapshot() const {
+    std::unordered_map<std::string, Host, StringHash, std::equal_to<>> merged;
+    for (size_t i = 0; shards_ && i <= mask_; ++i) {
+        std::lock_guard<std::mutex> lock(shards_[i].mutex);
+        for (const auto& [host, entry] : shards_[i].hosts) {
+            Host& total = merged.try_emplace(host, Host{host, 0, {}}).first->second;
+            total.requests += entry.requests;
+            total.traffic += entry.traffic;
+        }
+    }
+
+    std::vector<Host> result;
+    result.reserve(merged.size());
+    for (auto& [host, entry] : merged) {
+        result.push_back(std::move(entry));
+    }
+    std::sort(result.begin(), result.end(), [](const Host& a, const Host& b) { return a.host < b.host; });
+    return result;
+}
+
+TRAFFIC TrafficStats::total() const {
+    TRAFFIC total;
+    for (const Host& host : snapshot()) {
+        total += host.traffic;
+    }
+    return total;
+}
+
+struct ConnectionStats::State {
+    using Clock = std::chrono::steady_clock;
+    struct Socket {
+        std::string host;
+        Clock::time_point opened;
+    };
+    struct Requests {
+        uint64_t requests{0};
+        uint64_t reused{0};
+    };
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::unordered_map<std::string, Requests, StringHash, std::equal_to<>> hosts;
+    };
+
+    explicit State(size_t max_hosts) : limit(max_hosts) {}
+
+    std::mutex mutex; // Guards `sockets` and `hosts`
+    std::unordered_map<curl_socket_t, Socket> sockets;
+    std::unordered_map<std::string, Host, StringHash, std::equal_to<>> hosts;
+    std::unique_ptr<Shard[]> shards = std::make_unique<Shard[]>(counter_shards());
+    HostLimit limit;
+
+    Host& host(std::string_view name) {
+        auto it = hosts.find(name);
+        if (it == hosts.end()) {
+            name = limit.admit(name);
+            it = hosts.find(name);
+        }
+        if (it == hosts.end()) {
+            it = hosts.emplace(std::string(name), Host{std::string(name)}).first;
+        }
+        return it->second;
+    }
+};
+
+ConnectionStats::ConnectionStats(size_t max_hosts) : state_(std::make_unique<State>(max_hosts)) {}
+ConnectionStats::~ConnectionStats() = default;
+ConnectionStats::ConnectionStats(ConnectionStats&&) noexcept = default;
+ConnectionStats& ConnectionStats::operator=(ConnectionStats&&) noexcept = default;
+
+void ConnectionStats::attach(CURL* handle, Tap& tap, std::string_view host) const noexcept {
+    if (!state_) {
+        return; // Moved from
+    }
+    tap.state = state_.get();
+    tap.host = host;
+    curl_easy_setopt(handle, CURLOPT_OPENSOCKETFUNCTION, &ConnectionStats::open_socket);
+    curl_easy_setopt(handle, CURLOPT_OPENSOCKETDATA, &tap);
+    curl_easy_setopt(handle, CURLOPT_CLOSESOCKETFUNCTION, &ConnectionStats::close_socket);
+    curl_easy_setopt(handle, CURLOPT_CLOSESOCKETDATA, state_.get());
+}
+
+// What libcurl does without the callback, plus the bookkeeping
+curl_socket_t ConnectionStats::open_socket(void* data, curlsocktype purpose, curl_sockaddr* address) noexcept {
+    const curl_socket_t socket = ::socket(address->family, address->socktype | SOCK_CLOEXEC, address->protocol);
+    if (socket == CURL_SOCKET_BAD || purpose != CURLSOCKTYPE_IPCXN) {
+        return socket;
+    }
+    const Tap& tap = *static_cast<Tap*>(data);
+    try {
+        std::lock_guard<std::mutex> lock(tap.state->mutex);
+        Host& host = tap.state->host(tap.host);
+        ++host.opened;
+        tap.state->sockets[socket] = State::Socket{host.host, State::Clock::now()};
+    } catch (...) {
+        // Out of memory: the connection still works, it just goes uncounted
+    }
+    return socket;
+}
+
+int ConnectionStats::close_socket(void* data, curl_socket_t socket) noexcept {
+    State& state = *static_cast<State*>(data);
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        const auto it = state.sockets.find(socket);
+        if (it != state.sockets.end()) {
+            const auto lived = std::chrono::duration_cast<std::chrono::microseconds>(State::Clock::now() - it->second.opened);
+            Host& host = state.hosts.find(it->second.host)->second;
+            ++host.closed;
+            host.lifetime += lived;
+            host.longest = std::max(host.longest, lived);
+            state.sockets.erase(it);
+        }
+    }
+    return ::close(socket);
+}
+
+void ConnectionStats::record_request(std::string_view host, bool reused) {
+    if (!state_) {
+        return;
+    }
+    State::Shard& shard = state_->shards[thread_slot() & (counter_shards() - 1)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.hosts.find(host);
+    if (it == shard.hosts.end()) {
+        host = state_->limit.admit(host);
+        it = shard.hosts.find(host);
+    }
+    if (it == shard.hosts.end()) {
+        it = shard.hosts.emplace(std::string(host), State::Requests{}).first;
+    }
+    ++it->second.requests;
+    it->second.reused += reused ? 1 : 0;
+}
+
+std::vector<ConnectionStats::Host> ConnectionStats::snapshot() const {
+    std::vector<Host> result;
+    if (!state_) {
+        return result;
+    }
+    std::unordered_map<std::string, Host, StringHash, std::equal_to<>> merged;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        merged = state_->hosts;
+    }
+    for (size_t i = 0; i < counter_shards(); ++i) {
+        State::Shard& shard = state_->shards[i];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& [name, counts] : shard.hosts) {
+            Host& host = merged.try_emplace(name, Host{name}).first->second;
+            host.requests += counts.requests;
+            host.reused += counts.reused;
+        }
+    }
+
+    result.reserve(merged.size());
+    for (auto& [name, host] : merged) {
+        result.push_back(std::move(host));
+    }
+    std::sort(result.begin(), result.end(), [](const Host& a, const Host& b) { return a.host < b.host; });
+    return result;
+}
+
+} // namespace CurlX
@@ -0,0 +1,233 @@
+#include "CurlX/TimerWheel.hpp"
+#include <bit>
+#include <climits>
+#include <stdexcept>
+
+namespace CurlX {
+
+TimerWheel::TimerWheel(Clock::time_point origin) : origin_(origin) {
+    for (auto& level : slots_) {
+        level.fill(NIL);
+    }
+}
+
+TimerWheel::TimerId TimerWheel::schedule(Clock::time_point when, Callback callback) {
+    uint32_t index = free_;
+    if (index != NIL) {
+        free_ = nodes_[index].next;
+    } else {
+        if (nodes_.size() >= NIL) {
+            throw std::length_error("TimerWheel: too many timers");
+        }
+        index = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+
+    Node& node = nodes_[index];
+    node.expiry = to_tick(when);
+    node.callback = std::move(callback);
+    place(index);
+    ++size_;
+    return TimerId{index, node.generation};
+}
+
+bool TimerWheel::cancel(TimerId id) noexcept {
+    if (!id || id.index >= nodes_.size()) {
+        return false;
+    }
+    Node& node = nodes_[id.index];
+    if (node.generation != id.generation || node.list == FREE) {
+        return false;
+    }
+    unlink(id.index);
+    Callback discarded = std::move(node.callback);
+    release(id.index);
+    return true;
+}
+
+size_t TimerWheel::advance(Clock::time_point now) {
+    const uint64_t target = now > origin_
+        ? static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now - origin_).count())
+        : 0;
+
+    // Step from one occupied slot to the next instead of tick by tick: on a
+    // rotation boundary the matching slot of each higher level moves down,
+    // then the level 0 slot for the tick is due.
+    for (uint64_t tick = next_event_tick(); tick != NO_TICK && tick <= target; tick = next_event_tick()) {
+        now_tick_ = tick;
+        if ((tick & ((uint64_t{1} << (SLOT_BITS * LEVELS)) - 1)) == 0) {
+            cascade(OVERFLOW_LIST, 0);
+        }
+        for (size_t level = LEVELS - 1; level > 0; --level) {
+            const size_t shift = SLOT_BITS * level;
+            if ((tick & ((uint64_t{1} << shift) - 1)) == 0) {
+                cascade(static_cast<uint8_t>(level), static_cast<uint8_t>((tick >> shift) & (SLOTS - 1)));
+            }
+        }
+        cascade(0, static_cast<uint8_t>(tick & (SLOTS - 1)));
+    }
+    if (target > now_tick_) {
+        now_tick_ = target;
+    }
+    return fire_ready();
+}
+
+std::optional<TimerWheel::Clock::time_point> TimerWheel::next_expiry() const noexcept {
+    if (ready_ != NIL || firing_ != NIL) {
+        return origin_ + std::chrono::milliseconds(now_tick_);
+    }
+    const uint64_t tick = next_event_tick();
+    if (tick == NO_TICK) {
+        return std::nullopt;
+    }
+    return origin_ + std::chrono::milliseconds(tick);
+}
+
+int TimerWheel::poll_timeout(Clock::time_point now) const noexcept {
+    const auto next = next_expiry();
+    if (!next) {
+        return -1;
+    }
+    if (*next <= now) {
+        return 0;
+    }
+    const auto wait = std::chrono::ceil<std::chrono::milliseconds>(*next - now).count();
+    return wait > INT_MAX ? INT_MAX : static_cast<int>(wait);
+}
+
+// Rounded up, so a timer never fires before its time point
+uint64_t TimerWheel::to_tick(Clock::time_point when) const noexcept {
+    if (when <= origin_) {
+        return 0;
+    }
+    return static_cast<uint64_t>(std::chrono::ceil<std::chrono::milliseconds>(when - origin_).count());
+}
+
+// First tick after now_tick_ with a slot to fire or move down. A level holds
+// only timers of its current rotation, in slots after the current one, and
+// every such slot starts after all of the lower level's slots.
+uint64_t TimerWheel::next_event_tick() const noexcept {
+    for (size_t level = 0; level < LEVELS; ++level) {
+        const size_t shift = SLOT_BITS * level;
+        const uint64_t current = (now_tick_ >> shift) & (SLOTS - 1);
+        const uint64_t later = current == SLOTS - 1 ? 0 : occupied_[level] & (~uint64_t{0} << (current + 1));
+        if (later != 0) {
+            const size_t rotation = shift + SLOT_BITS;
+            return ((now_tick_ >> rotation) << rotation) + (static_cast<uint64_t>(std::countr_zero(later)) << shift);
+        }
+    }
+    if (overflow_ != NIL) {
+        const size_t span = SLOT_BITS * LEVELS;
+        return ((now_tick_ >> span) + 1) << span;
+    }
+    return NO_TICK;
+}
+
+uint32_t& TimerWheel::head(uint8_t list, uint8_t slot) noexcept {
+    switch (list) {
+        case READY: return ready_;
+        case OVERFLOW_LIST: return overflow_;
+        case FIRING: return firing_;
+        default: return slots_[list][slot];
+    }
+}
+
+void TimerWheel::link(uint32_t index, uint8_t list, uint8_t slot) noexcept {
+    Node& node = nodes_[index];
+    uint32_t& first = head(list, slot);
+    node.list = list;
+    node.slot = slot;
+    node.prev = NIL;
+    node.next = first;
+    if (first != NIL) {
+        nodes_[first].prev = index;
+    }
+    first = index;
+    if (list < LEVELS) {
+        occupied_[list] |= uint64_t{1} << slot;
+    }
+}
+
+void TimerWheel::unlink(uint32_t index) noexcept {
+    Node& node = nodes_[index];
+    if (node.prev != NIL) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        head(node.list, node.slot) = node.next;
+    }
+    if (node.next != NIL) {
+        nodes_[node.next].prev = node.prev;
+    }
+    if (node.list < LEVELS && slots_[node.list][node.slot] == NIL) {
+        occupied_[node.list] &= ~(uint64_t{1} << node.slot);
+    }
+    node.prev = NIL;
+    node.next = NIL;
+}
+
+// The lowest level whose current rotation contains the expiry
+void TimerWheel::place(uint32_t index) noexcept {
+    const uint64_t expiry = nodes_[index].expiry;
+    if (expiry <= now_tick_) {
+        link(index, READY, 0);
+        return;
+    }
+    for (size_t level = 0; level < LEVELS; ++level) {
+        const size_t shift = SLOT_BITS * level;
+        if ((expiry >> (shift + SLOT_BITS)) == (now_tick_ >> (shift + SLOT_BITS))) {
+            link(index, static_cast<uint8_t>(level), static_cast<uint8_t>((expiry >> shift) & (SLOTS - 1)));
+            return;
+        }
+    }
+    link(index, OVERFLOW_LIST, 0);
+}
+
+void TimerWheel::cascade(uint8_t list, uint8_t slot) noexcept {
+    uint32_t index = head(list, slot);
+    head(list, slot) = NIL;
+    if (list < LEVELS) {
+        occupied_[list] &= ~(uint64_t{1} << slot);
+    }
+    while (index != NIL) {
+        const uint32_t next = nodes_[index].next;
+        place(index);
+        index = next;
+    }
+}
+
+void TimerWheel::release(uint32_t index) noexcept {
+    Node& node = nodes_[index];
+    if (++node.generation == 0) {
+        node.generation = 1;
+    }
+    node.list = FREE;
+    node.prev = NIL;
+    node.next = free_;
+    free_ = index;
+    --size_;
+}
+
+// Each node is released before its callback runs, so callbacks may schedule
+// and cancel freely. If a callback throws, the rest fire on the next advance().
+size_t TimerWheel::fire_ready() {
+    while (ready_ != NIL) {
+        const uint32_t index = ready_;
+        unlink(index);
+        link(index, FIRING, 0);
+    }
+
+    size_t fired = 0;
+    while (firing_ != NIL) {
+        const uint32_t index = firing_;
+        unlink(index);
+        Callback callback = std::move(nodes_[index].callback);
+        release(index);
+        ++fired;
+        if (callback) {
+            callback();
+        }
+    }
+    return fired;
+}
+
+} // namespace CurlX
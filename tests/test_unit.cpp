@@ -1,9 +1,69 @@
 #include "CurlX/CurlX.hpp"
 #include <iostream>
 #include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <sstream>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 using namespace CurlX;
 
+void test_runtime_allocator() {
+    std::cout << "Testing runtime allocator..." << std::endl;
+    
+    // Must run before anything else touches libcurl
+    Runtime::initialize(Runtime::Allocator::Pooled);
+    assert(Runtime::is_initialized());
+    assert(Runtime::allocator() == Runtime::Allocator::Pooled);
+    
+    [[maybe_unused]] bool rejected = false;
+    try {
+        Runtime::initialize(Runtime::Allocator::Counting);
+    } catch (const RequestException&) {
+        rejected = true;
+    }
+    assert(rejected);
+    
+    [[maybe_unused]] const AllocationStats before = Runtime::allocation_stats();
+    {
+        Session session;
+        HEADERS headers;
+        headers.add("Accept", "application/json");
+        struct curl_slist* list = headers.to_curl_slist();
+        assert(list != nullptr);
+        headers.free_curl_slist(list);
+    }
+    [[maybe_unused]] const AllocationStats after = Runtime::allocation_stats();
+    assert(after.allocations > before.allocations);
+    assert(after.frees > before.frees);
+    assert(after.peak_bytes_in_use >= after.bytes_in_use);
+    assert(after.cache_hits >= before.cache_hits);
+    
+    // Counted in the allocating thread's shard, freed from this one
+    struct curl_slist* shared = nullptr;
+    std::thread producer([&shared] {
+        HEADERS headers;
+        headers.add("X-Shard", "1");
+        shared = headers.to_curl_slist();
+    });
+    producer.join();
+    assert(shared != nullptr);
+    [[maybe_unused]] const AllocationStats produced = Runtime::allocation_stats();
+    curl_slist_free_all(shared);
+    [[maybe_unused]] const AllocationStats freed = Runtime::allocation_stats();
+    assert(produced.allocations > after.allocations);
+    assert(freed.frees > produced.frees);
+    assert(freed.bytes_in_use < produced.bytes_in_use);
+    assert(freed.peak_bytes_in_use >= produced.bytes_in_use);
+    
+    std::cout << "✓ Runtime allocator test passed" << std::endl;
+}
+
 void test_headers_basic() {
     std::cout << "Testing basic headers functionality..." << std::endl;
     
@@ -69,6 +129,652 @@ void test_session_basic() {
     std::cout << "✓ Basic session test passed" << std::endl;
 }
 
+void test_trusted_session() {
+    std::cout << "Testing policy-based sessions..." << std::endl;
+    
+    static_assert(std::is_same_v<Session, BasicSession<DefaultPolicy>>);
+    static_assert(!TrustedSession::policy_type::collect_statistics);
+    
+    TrustedSession trusted;
+    assert(trusted.is_valid());
+    
+    // Both policies fail an unreachable host the same way; only the default one counts it
+    Session session;
+    [[maybe_unused]] bool default_failed = false;
+    [[maybe_unused]] bool trusted_failed = false;
+    try {
+        session.GET(URL("http://127.0.0.1:1/"));
+    } catch (const ConnectionError&) {
+        default_failed = true;
+    }
+    HEADERS accept;
+    accept.add("Accept", "application/json");
+    try {
+        GET(trusted, URL("http://127.0.0.1:1/"), accept);
+    } catch (const ConnectionError&) {
+        trusted_failed = true;
+    }
+    assert(default_failed && trusted_failed);
+    assert(session.get_request_count() == 1);
+    assert(trusted.get_request_count() == 0);
+    
+    // Header lines are taken as-is on the trusted path
+    HEADERS headers;
+    headers.add_unchecked("X-Trace: 1");
+    assert(headers.size() == 1 && headers.get("X-Trace").has_value());
+    
+    std::cout << "✓ Policy-based session test passed" << std::endl;
+}
+
+// Stands in for a Session: records what reached it and answers with a fixed status
+struct RecordingTarget {
+    std::vector<long> statuses;
+    size_t calls{0};
+    size_t header_count{0};
+    
+    RESPONSE send(const REQUEST& request) {
+        header_count = request.get_headers().size();
+        const long status = statuses[std::min(calls, statuses.size() - 1)];
+        ++calls;
+        RESPONSE response;
+        response.statusCode = status;
+        return response;
+    }
+};
+
+void test_pipeline() {
+    std::cout << "Testing interceptor pipeline..." << std::endl;
+    
+    RecordingTarget target{{503, 503, 200}};
+    size_t observed = 0;
+    long last_status = 0;
+    Pipeline pipeline(target,
+                      HeaderStamp("X-Service", "billing"),
+                      Retry(3, std::chrono::milliseconds(0)),
+                      Observer([&](const REQUEST&, const RESPONSE& response, [[maybe_unused]] double seconds) {
+                          ++observed;
+                          last_status = response.statusCode;
+                          assert(seconds >= 0.0);
+                      }));
+    static_assert(decltype(pipeline)::size() == 3);
+    
+    REQUEST request(URL("http://example.com"));
+    [[maybe_unused]] RESPONSE response = pipeline.send(request);
+    assert(response.statusCode == 200);
+    assert(target.calls == 3);          // Two 503s retried
+    assert(observed == 3 && last_status == 200); // Observer sits inside Retry
+    assert(target.header_count == 1);
+    
+    // Stamping is idempotent on a reused request, and an existing header wins
+    target.calls = 0;
+    pipeline.send(request);
+    assert(target.header_count == 1);
+    REQUEST preset(URL("http://example.com"));
+    preset.headers_.add("x-service", "other");
+    pipeline.send(std::move(preset));
+    assert(target.header_count == 1);
+    
+    // Retry gives up after max_attempts and returns the last response
+    RecordingTarget failing{{503}};
+    Pipeline retrying(failing, Retry(2, std::chrono::milliseconds(0)));
+    assert(retrying.send(REQUEST(URL("http://example.com"))).statusCode == 503);
+    assert(failing.calls == 2);
+    
+    // Pipelines nest, and an empty pipeline forwards straight to the target
+    Pipeline outer(pipeline, HeaderStamp("X-Outer", "1"));
+    target.calls = 0;
+    outer.send(REQUEST(URL("http://example.com")));
+    assert(target.header_count == 2);
+    Pipeline<RecordingTarget> passthrough(target);
+    assert(passthrough.send(REQUEST(URL("http://example.com"))).statusCode == 200);
+    
+    [[maybe_unused]] bool rejected = false;
+    try {
+        HeaderStamp("Bad:Name", "x");
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    assert(rejected);
+    
+    std::cout << "✓ Interceptor pipeline test passed" << std::endl;
+}
+
+void test_try_send() {
+    std::cout << "Testing non-throwing send..." << std::endl;
+    
+    static_assert(sizeof(Error) <= 8);
+    
+    Session session;
+    REQUEST refused(URL("http://127.0.0.1:1/"));
+    [[maybe_unused]] auto result = session.try_send(refused);
+    assert(!result.has_value());
+    assert(result.error().code == CURLE_COULDNT_CONNECT);
+    assert(result.error().phase == Error::Phase::Connect);
+    assert(result.error().is_connection_error());
+    assert(result.error().phase_name() == "connect");
+    assert(session.get_request_count() == 1); // Failures are still counted
+    
+    // The throwing API raises the same exception as before
+    [[maybe_unused]] bool thrown = false;
+    try {
+        session.send(refused);
+    } catch (const ConnectionError& e) {
+        thrown = std::string_view(e.what()).find(result.error().message()) != std::string_view::npos;
+    }
+    assert(thrown);
+    
+    // Setup failures never reach libcurl, and keep their own codes
+    [[maybe_unused]] auto invalid = session.try_send(REQUEST(URL("http://[::1")));
+    assert(!invalid && invalid.error().phase == Error::Phase::Setup);
+    assert(invalid.error().code == CURLE_URL_MALFORMAT);
+    REQUEST unwritable(URL("http://127.0.0.1:1/"));
+    unwritable.output_file_path("/nonexistent-curlx-dir/out.bin");
+    [[maybe_unused]] auto write_failed = session.try_send(unwritable);
+    assert(!write_failed && write_failed.error().phase == Error::Phase::Setup);
+    assert(write_failed.error().code == CURLE_WRITE_ERROR);
+    [[maybe_unused]] bool invalid_thrown = false;
+    try {
+        session.send(REQUEST(URL("http://[::1")));
+    } catch (const RequestException& e) {
+        invalid_thrown = std::string_view(e.what()).starts_with("Invalid URL");
+    }
+    assert(invalid_thrown);
+    
+    // Error::raise maps codes to the exception hierarchy
+    [[maybe_unused]] bool timed_out = false;
+    try {
+        Error{CURLE_OPERATION_TIMEDOUT, Error::Phase::Transfer}.raise();
+    } catch (const Timeout&) {
+        timed_out = true;
+    }
+    assert(timed_out);
+    
+    RESPONSE response;
+    response.body = ResponseBody(std::string("{\"id\": 7}"));
+    [[maybe_unused]] auto parsed = response.try_json();
+    assert(parsed && (*parsed)["id"] == 7);
+    
+    RESPONSE broken;
+    broken.body = ResponseBody(std::string("{\"id\": "));
+    [[maybe_unused]] auto failed = broken.try_json();
+    assert(!failed && failed.error() == (Error{CURLE_OK, Error::Phase::Parse}));
+    assert(!broken.json_safe().has_value());
+    
+    std::cout << "✓ Non-throwing send test passed" << std::endl;
+}
+
+// Accepts connections on a loopback port and never answers
+struct SilentServer {
+    int listener{-1};
+    int client{-1};
+    uint16_t port{0};
+    std::thread acceptor;
+    
+    SilentServer() {
+        listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        ::listen(listener, 4);
+        socklen_t length = sizeof(address);
+        ::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length);
+        port = ntohs(address.sin_port);
+        acceptor = std::thread([this] { client = ::accept(listener, nullptr, nullptr); });
+    }
+    
+    ~SilentServer() {
+        ::shutdown(listener, SHUT_RDWR);
+        acceptor.join();
+        if (client >= 0) ::close(client);
+        ::close(listener);
+    }
+    
+    std::string url() const { return "http://127.0.0.1:" + std::to_string(port) + "/"; }
+};
+
+// Answers every request with a small 200 and keeps the connection open.
+// Serves one connection at a time.
+struct ReplyServer {
+    int listener{-1};
+    std::atomic<int> client{-1};
+    uint16_t port{0};
+    std::thread acceptor;
+    
+    ReplyServer() {
+        listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        ::listen(listener, 16);
+        socklen_t length = sizeof(address);
+        ::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length);
+        port = ntohs(address.sin_port);
+        acceptor = std::thread([this] { serve(); });
+    }
+    
+    ~ReplyServer() {
+        ::shutdown(listener, SHUT_RDWR);
+        const int open = client.load();
+        if (open >= 0) ::shutdown(open, SHUT_RDWR);
+        acceptor.join();
+        ::close(listener);
+    }
+    
+    void serve() {
+        static constexpr std::string_view reply = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok";
+        for (int connection; (connection = ::accept(listener, nullptr, nullptr)) >= 0;) {
+            client = connection;
+            std::string pending;
+            char buffer[4096];
+            for (ssize_t got; (got = ::recv(connection, buffer, sizeof(buffer), 0)) > 0;) {
+                pending.append(buffer, static_cast<size_t>(got));
+                for (size_t end; (end = pending.find("\r\n\r\n")) != std::string::npos;) {
+                    pending.erase(0, end + 4);
+                    [[maybe_unused]] const ssize_t sent = ::send(connection, reply.data(), reply.size(), MSG_NOSIGNAL);
+                }
+            }
+            client = -1;
+            ::close(connection);
+        }
+    }
+    
+    std::string url() const { return "http://127.0.0.1:" + std::to_string(port) + "/"; }
+};
+
+// On one connection: a 302 whose 64KB body arrives in two halves 300ms apart,
+// then a 200 whose 30-byte body trickles in 10 bytes every 150ms
+struct TrickleRedirectServer {
+    int listener{-1};
+    uint16_t port{0};
+    std::thread acceptor;
+    
+    TrickleRedirectServer() {
+        listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        ::listen(listener, 4);
+        socklen_t length = sizeof(address);
+        ::getsockname(listener, reinterpret_cast<sockaddr*>(&address), &length);
+        port = ntohs(address.sin_port);
+        acceptor = std::thread([this] { serve(); });
+    }
+    
+    ~TrickleRedirectServer() {
+        ::shutdown(listener, SHUT_RDWR);
+        acceptor.join();
+        ::close(listener);
+    }
+    
+    static bool read_request(int connection) {
+        std::string pending;
+        char buffer[4096];
+        while (pending.find("\r\n\r\n") == std::string::npos) {
+            const ssize_t got = ::recv(connection, buffer, sizeof(buffer), 0);
+            if (got <= 0) return false;
+            pending.append(buffer, static_cast<size_t>(got));
+        }
+        return true;
+    }
+    
+    static void send_all(int connection, std::string_view data) {
+        [[maybe_unused]] const ssize_t sent = ::send(connection, data.data(), data.size(), MSG_NOSIGNAL);
+    }
+    
+    void serve() {
+        using namespace std::chrono;
+        const int connection = ::accept(listener, nullptr, nullptr);
+        if (connection < 0) return;
+        const std::string half(32 * 1024, 'r');
+        if (read_request(connection)) {
+            send_all(connection, "HTTP/1.1 302 Found\r\nLocation: /final\r\nContent-Length: 65536\r\n\r\n");
+            send_all(connection, half);
+            std::this_thread::sleep_for(milliseconds(300));
+            send_all(connection, half);
+        }
+        if (read_request(connection)) {
+            send_all(connection, "HTTP/1.1 200 OK\r\nContent-Length: 30\r\n\r\n");
+            for (int i = 0; i < 3; ++i) {
+                std::this_thread::sleep_for(milliseconds(150));
+                send_all(connection, "0123456789");
+            }
+        }
+        ::close(connection);
+    }
+    
+    std::string url() const { return "http://127.0.0.1:" + std::to_string(port) + "/start"; }
+};
+
+void test_timeouts() {
+    std::cout << "Testing millisecond timeouts..." << std::endl;
+    using namespace std::chrono;
+    
+    assert(TIMEOUT(milliseconds(250)).total == milliseconds(250));
+    assert(TIMEOUT(microseconds(1)).total == milliseconds(1)); // Rounded up, never "no limit"
+    assert(TIMEOUT(2).value() == 2 && !TIMEOUT().has_limit());
+    
+    const auto now = TIMEOUT::Clock::now();
+    [[maybe_unused]] TIMEOUT pinned = TIMEOUT(milliseconds(300)).pin(now);
+    assert(pinned.total.count() == 0 && pinned.deadline == now + milliseconds(300));
+    assert(pinned.remaining(now + milliseconds(100)) == milliseconds(200));
+    assert(pinned.remaining(now + seconds(1)) == milliseconds(0));
+    
+    // A spent deadline fails before any I/O
+    Session session;
+    [[maybe_unused]] auto expired = session.try_send(
+        REQUEST(URL("http://127.0.0.1:1/")).timeout(TIMEOUT::at(now - milliseconds(1))));
+    assert(!expired && expired.error().is_timeout() && expired.error().phase == Error::Phase::Setup);
+    
+    // Sub-second limits are applied (whole seconds used to truncate 0.15s to "no limit")
+    {
+        SilentServer server;
+        REQUEST request(URL(server.url()));
+        request.timeout(TIMEOUT(milliseconds(150)));
+        const auto start = steady_clock::now();
+        [[maybe_unused]] auto result = session.try_send(request);
+        [[maybe_unused]] const auto elapsed = steady_clock::now() - start;
+        assert(!result && result.error().is_timeout() && result.error().phase == Error::Phase::Transfer);
+        assert(elapsed >= milliseconds(140) && elapsed < seconds(2));
+    }
+    
+    // Stall detection cuts off a connection that sends nothing long before the overall limit
+    {
+        SilentServer server;
+        REQUEST request(URL(server.url()));
+        request.timeout(TIMEOUT(seconds(30)).stall(1, milliseconds(200)));
+        [[maybe_unused]] const auto start = steady_clock::now();
+        [[maybe_unused]] bool stalled = false;
+        try {
+            session.send(request);
+        } catch (const Timeout& e) {
+            stalled = std::string_view(e.what()).find("stalled") != std::string_view::npos;
+        }
+        assert(stalled);
+        assert(steady_clock::now() - start < seconds(3));
+    }
+    
+    // Byte counters restart on each redirect hop; a healthy second hop is not a stall
+    {
+        TrickleRedirectServer server;
+        REQUEST request(URL(server.url()));
+        request.timeout(TIMEOUT(seconds(30)).stall(1, milliseconds(200)));
+        [[maybe_unused]] auto result = session.try_send(request);
+        assert(result && result->statusCode == 200 && result->text() == "012345678901234567890123456789");
+    }
+    
+    // Retry shares one deadline across attempts
+    RecordingTarget target{{503}};
+    Pipeline retrying(target, Retry(10, milliseconds(20)));
+    REQUEST request(URL("http://example.com"));
+    request.timeout(TIMEOUT(milliseconds(30)));
+    retrying.send(request);
+    assert(target.calls == 2); // A third attempt would start after the deadline
+    assert(request.get_timeout().total == milliseconds(30) && !request.get_timeout().deadline);
+    
+    std::cout << "✓ Millisecond timeout test passed" << std::endl;
+}
+
+void test_cancellation() {
+    std::cout << "Testing cancellation..." << std::endl;
+    using namespace std::chrono;
+    
+    Session session;
+    
+    // A token stopped before send fails before any I/O
+    std::stop_source stopped;
+    stopped.request_stop();
+    [[maybe_unused]] auto early = session.try_send(REQUEST(URL("http://127.0.0.1:1/")).cancel_on(stopped.get_token()));
+    assert(!early && early.error().is_cancelled() && early.error().phase == Error::Phase::Setup);
+    
+    // A stop request interrupts a transfer that is waiting on the network
+    {
+        SilentServer server;
+        std::stop_source source;
+        std::thread canceller([&] {
+            std::this_thread::sleep_for(milliseconds(100));
+            source.request_stop();
+        });
+        REQUEST request(URL(server.url()));
+        request.cancel_on(source.get_token());
+        const auto start = steady_clock::now();
+        [[maybe_unused]] auto result = session.try_send(request);
+        [[maybe_unused]] const auto elapsed = steady_clock::now() - start;
+        canceller.join();
+        assert(!result && result.error().is_cancelled() && !result.error().is_timeout());
+        assert(elapsed < milliseconds(500)); // Not the next poll timeout
+    }
+    
+    // send() throws Cancelled; the token can be passed like any other option
+    {
+        SilentServer server;
+        std::stop_source source;
+        std::thread canceller([&] {
+            std::this_thread::sleep_for(milliseconds(50));
+            source.request_stop();
+        });
+        [[maybe_unused]] bool cancelled = false;
+        try {
+            GET(session, URL(server.url()), source.get_token());
+        } catch (const Cancelled&) {
+            cancelled = true;
+        }
+        canceller.join();
+        assert(cancelled);
+    }
+    
+    // Retry neither sleeps nor tries again once the request is cancelled
+    RecordingTarget target{{503, 503, 503}};
+    Pipeline retrying(target, Retry(3, seconds(5)));
+    std::stop_source source;
+    source.request_stop();
+    REQUEST request(URL("http://example.com"));
+    request.cancel_on(source.get_token());
+    retrying.send(request);
+    assert(target.calls == 1);
+    
+    // A stop request during the backoff ends the wait at once
+    {
+        RecordingTarget backing_off{{503, 503, 503}};
+        Pipeline patient(backing_off, Retry(3, seconds(5)));
+        std::stop_source later;
+        REQUEST waiting(URL("http://example.com"));
+        waiting.cancel_on(later.get_token());
+        std::thread canceller([&] {
+            std::this_thread::sleep_for(milliseconds(50));
+            later.request_stop();
+        });
+        const auto start = steady_clock::now();
+        [[maybe_unused]] bool cancelled = false;
+        try {
+            patient.send(waiting);
+        } catch (const Cancelled&) {
+            cancelled = true;
+        }
+        [[maybe_unused]] const auto elapsed = steady_clock::now() - start;
+        canceller.join();
+        assert(cancelled && backing_off.calls == 1 && elapsed < seconds(2));
+    }
+    
+    std::cout << "✓ Cancellation test passed" << std::endl;
+}
+
+void test_timer_wheel() {
+    std::cout << "Testing timer wheel..." << std::endl;
+    using namespace std::chrono;
+    
+    const auto origin = TimerWheel::Clock::now();
+    TimerWheel wheel(origin);
+    std::vector<int> fired;
+    
+    // One timer per level, and one past the wheel's span
+    const milliseconds delays[] = {milliseconds(5), milliseconds(100), seconds(5), seconds(300), hours(6)};
+    for (int i = 0; i < 5; ++i) {
+        wheel.schedule(origin + delays[i], [&fired, i] { fired.push_back(i); });
+    }
+    const auto cancelled = wheel.schedule(origin + milliseconds(50), [&fired] { fired.push_back(-1); });
+    assert(wheel.size() == 6 && wheel.next_expiry() == origin + milliseconds(5));
+    [[maybe_unused]] const bool first_cancel = wheel.cancel(cancelled);
+    [[maybe_unused]] const bool second_cancel = wheel.cancel(cancelled);
+    assert(first_cancel && !second_cancel);
+    for (size_t i = 0; i < 5; ++i) {
+        wheel.advance(origin + delays[i] - milliseconds(1));
+        assert(fired.size() == i); // Never early
+        wheel.advance(origin + delays[i]);
+        assert(fired.size() == i + 1 && fired.back() == static_cast<int>(i));
+    }
+    assert(wheel.empty() && !wheel.next_expiry() && wheel.poll_timeout() == -1);
+    
+    // A recycled node does not answer to a stale id
+    const auto now = origin + hours(7);
+    const auto stale = wheel.schedule(now, [] {});
+    wheel.advance(now);
+    const auto fresh = wheel.schedule(now + seconds(1), [] {});
+    [[maybe_unused]] const bool stale_cancel = wheel.cancel(stale);
+    [[maybe_unused]] const bool fresh_cancel = wheel.cancel(fresh);
+    assert(fresh.index == stale.index && !stale_cancel && fresh_cancel);
+    
+    // Timers scheduled by a callback for "now" wait for the next advance()
+    int nested = 0;
+    wheel.schedule(now, [&] { wheel.schedule(now, [&nested] { ++nested; }); });
+    [[maybe_unused]] const size_t outer = wheel.advance(now);
+    assert(outer == 1 && nested == 0 && wheel.poll_timeout(now) == 0);
+    [[maybe_unused]] const size_t inner = wheel.advance(now);
+    assert(inner == 1 && nested == 1);
+    
+    // Random expiries and advance steps: each timer fires at the first advance at or after it
+    TimerWheel random_wheel(origin);
+    std::vector<milliseconds> expiry(2000);
+    std::vector<milliseconds> fired_at(expiry.size(), milliseconds(-1));
+    std::vector<TimerWheel::TimerId> ids(expiry.size());
+    milliseconds clock(0);
+    uint32_t seed = 12345;
+    const auto next_random = [&seed](uint32_t bound) {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 8) % bound;
+    };
+    for (size_t i = 0; i < expiry.size(); ++i) {
+        expiry[i] = milliseconds(next_random(300000));
+        ids[i] = random_wheel.schedule(origin + expiry[i], [&fired_at, &clock, i] { fired_at[i] = clock; });
+    }
+    for (size_t i = 0; i < expiry.size(); i += 3) {
+        random_wheel.cancel(ids[i]);
+    }
+    while (!random_wheel.empty()) {
+        clock += milliseconds(1 + next_random(5000));
+        random_wheel.advance(origin + clock);
+    }
+    for (size_t i = 0; i < expiry.size(); ++i) {
+        if (i % 3 == 0) {
+            assert(fired_at[i] == milliseconds(-1));
+        } else {
+            assert(fired_at[i] >= expiry[i] && fired_at[i] - expiry[i] <= milliseconds(5000));
+        }
+    }
+    
+    std::cout << "✓ Timer wheel test passed" << std::endl;
+}
+
+void test_async_session() {
+    std::cout << "Testing async session..." << std::endl;
+    using namespace std::chrono;
+    
+    Session session;
+    {
+        AsyncSession async(session);
+        
+        // Deadlines of concurrent requests run side by side on the loop's timer wheel
+        {
+            SilentServer server;
+            std::vector<std::future<RESPONSE>> responses;
+            const auto start = steady_clock::now();
+            for (int i = 0; i < 8; ++i) {
+                responses.push_back(async.send(REQUEST(URL(server.url())).timeout(TIMEOUT(milliseconds(150)))));
+            }
+            [[maybe_unused]] size_t timeouts = 0;
+            for (auto& response : responses) {
+                try {
+                    response.get();
+                } catch (const Timeout&) {
+                    ++timeouts;
+                }
+            }
+            [[maybe_unused]] const auto elapsed = steady_clock::now() - start;
+            assert(timeouts == 8);
+            assert(elapsed >= milliseconds(140) && elapsed < milliseconds(800)); // One after another would take 1.2s
+        }
+        
+        // Callback form: errors arrive as values
+        std::promise<std::expected<RESPONSE, Error>> refused;
+        auto refused_result = refused.get_future();
+        async.send(REQUEST(URL("http://127.0.0.1:1/")), [&refused](std::expected<RESPONSE, Error> result) {
+            refused.set_value(std::move(result));
+        });
+        [[maybe_unused]] const auto refused_value = refused_result.get();
+        assert(!refused_value && refused_value.error().is_connection_error());
+        
+        // Stop tokens cancel in-flight requests
+        {
+            SilentServer server;
+            std::stop_source source;
+            auto response = async.send(REQUEST(URL(server.url())).cancel_on(source.get_token()));
+            std::this_thread::sleep_for(milliseconds(50));
+            source.request_stop();
+            [[maybe_unused]] bool cancelled = false;
+            try {
+                response.get();
+            } catch (const Cancelled&) {
+                cancelled = true;
+            }
+            assert(cancelled);
+        }
+        
+        // Timers for the caller, e.g. retry backoff
+        std::promise<void> timer;
+        auto timer_fired = timer.get_future();
+        async.after(milliseconds(20), [&timer] { timer.set_value(); });
+        assert(timer_fired.wait_for(seconds(2)) == std::future_status::ready);
+        assert(async.in_flight() == 0);
+    }
+    
+    // Destroying the AsyncSession cancels what is still in flight
+    SilentServer server;
+    std::future<RESPONSE> orphan;
+    {
+        AsyncSession async(session);
+        orphan = async.send(REQUEST(URL(server.url())));
+        std::this_thread::sleep_for(milliseconds(20));
+    }
+    [[maybe_unused]] bool cancelled = false;
+    try {
+        orphan.get();
+    } catch (const Cancelled&) {
+        cancelled = true;
+    }
+    assert(cancelled);
+    
+    // A trusted session drives its own loop, and a per-host limit set after
+    // construction still applies: ReplyServer only serves one connection at a time
+    {
+        ReplyServer replies;
+        TrustedSession trusted;
+        TrustedAsyncSession trusted_async(trusted);
+        trusted.set_max_connections_per_host(1);
+        std::vector<std::future<RESPONSE>> responses;
+        for (int i = 0; i < 4; ++i) {
+            responses.push_back(trusted_async.send(REQUEST(URL(replies.url())).timeout(TIMEOUT(seconds(5)))));
+        }
+        for (auto& response : responses) {
+            [[maybe_unused]] const RESPONSE done = response.get();
+            assert(done.statusCode == 200);
+        }
+    }
+    
+    std::cout << "✓ Async session test passed" << std::endl;
+}
+
 void test_response_basic() {
     std::cout << "Testing basic response functionality..." << std::endl;
     
@@ -86,6 +792,563 @@ void test_response_basic() {
     std::cout << "✓ Basic response test passed" << std::endl;
 }
 
+void test_response_timings() {
+    std::cout << "Testing response timings..." << std::endl;
+    using namespace std::chrono;
+    
+    TIMINGS timings;
+    timings.name_lookup = microseconds(100);
+    timings.connect = microseconds(300);
+    timings.app_connect = microseconds(900);
+    timings.pre_transfer = microseconds(950);
+    timings.start_transfer = microseconds(2950);
+    timings.total = microseconds(3000);
+    timings.new_connections = 1;
+    assert(timings.dns() == microseconds(100) && timings.tcp() == microseconds(200));
+    assert(timings.tls() == microseconds(600) && timings.server() == microseconds(2000));
+    assert(timings.download() == microseconds(50) && !timings.reused_connection());
+    timings.app_connect = microseconds(0);
+    assert(timings.tls() == microseconds(0)); // Plain HTTP
+    
+    ReplyServer server;
+    Session session;
+    const RESPONSE first = session.send(REQUEST(URL(server.url())));
+    const RESPONSE second = session.send(REQUEST(URL(server.url())));
+    [[maybe_unused]] const TIMINGS& fresh = first.timings;
+    assert(first.statusCode == 200 && fresh.new_connections == 1 && !fresh.reused_connection());
+    assert(fresh.connect >= fresh.name_lookup && fresh.pre_transfer >= fresh.connect);
+    assert(fresh.start_transfer >= fresh.pre_transfer && fresh.total >= fresh.start_transfer);
+    assert(fresh.total.count() > 0 && first.elapsed_time == duration<double>(fresh.total).count());
+    assert(second.timings.reused_connection()); // Keep-alive worked
+    
+    std::cout << "✓ Response timings test passed" << std::endl;
+}
+
+void test_latency_stats() {
+    std::cout << "Testing latency histograms..." << std::endl;
+    using namespace std::chrono;
+    
+    // Exact below 32us, then within 1/16 of the value
+    static_assert(LatencyBuckets::index(31) == 31 && LatencyBuckets::lowest(31) == 31);
+    for (const uint64_t value : {uint64_t{0}, uint64_t{32}, uint64_t{1000}, uint64_t{123456}, uint64_t{1} << 35}) {
+        [[maybe_unused]] const size_t index = LatencyBuckets::index(value);
+        assert(LatencyBuckets::lowest(index) <= value && value <= LatencyBuckets::highest(index));
+        assert(LatencyBuckets::highest(index) - LatencyBuckets::lowest(index) <= value / 16);
+    }
+    assert(LatencyBuckets::index(uint64_t{1} << 40) == LatencyBuckets::COUNT - 1);
+    
+    LatencySnapshot snapshot;
+    for (int i = 1; i <= 1000; ++i) {
+        snapshot.record(microseconds(i * 100));
+    }
+    assert(snapshot.count() == 1000 && snapshot.max() == microseconds(100000));
+    assert(snapshot.p50() >= microseconds(50000) && snapshot.p50() <= microseconds(53125));
+    assert(snapshot.p99() >= microseconds(99000) && snapshot.p999() == microseconds(100000));
+    LatencySnapshot other;
+    other.record(microseconds(5000000));
+    snapshot.merge(other);
+    assert(snapshot.count() == 1001 && snapshot.max() == seconds(5) && snapshot.percentile(1.0) == seconds(5));
+    
+    // Each thread records into its own shard; a snapshot sees them all
+    LatencyStats stats;
+    {
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&stats, t] {
+                for (int i = 0; i < 1000; ++i) {
+                    stats.record("http://a:80", t % 2 ? "GET" : "POST", i % 10 ? 200 : 503, microseconds(900));
+                }
+            });
+        }
+    }
+    stats.record("http://b:80", "GET", 0, milliseconds(2));
+    const auto entries = stats.snapshot();
+    assert(entries.size() == 5 && stats.total().count() == 4001);
+    assert(entries.front().first.host == "http://a:80" && entries.front().first.method == "GET");
+    assert(entries.front().first.status == "2xx" && entries.front().second.count() == 1800);
+    assert(entries.back().first.status == "failed");
+    
+    const std::string text = stats.prometheus();
+    assert(text.find("# TYPE curlx_request_duration_seconds histogram") != std::string::npos);
+    assert(text.find("curlx_request_duration_seconds_bucket{host=\"http://a:80\",method=\"GET\",status=\"2xx\",le=\"0.001\"} 1800") != std::string::npos);
+    assert(text.find("curlx_request_duration_seconds_count{host=\"http://b:80\",method=\"GET\",status=\"failed\"} 1") != std::string::npos);
+    assert(text.find("quantile=\"0.99\"} 0.0009") != std::string::npos);
+    
+    // Hosts past the cap share one label, so keys stay bounded
+    LatencyStats capped(2);
+    for (int i = 0; i < 100; ++i) {
+        capped.record("http://host" + std::to_string(i) + ":80", "GET", 200, microseconds(10));
+    }
+    capped.record("http://host1:80", "GET", 200, microseconds(10));
+    [[maybe_unused]] const auto folded = capped.snapshot();
+    assert(folded.size() == 3 && capped.total().count() == 101);
+    assert(folded[0].first.host == "http://host0:80" && folded[1].first.host == "http://host1:80");
+    assert(folded[1].second.count() == 2);
+    assert(folded[2].first.host == HostLimit::OTHER_HOST && folded[2].second.count() == 98);
+    
+    // Sessions record every request
+    ReplyServer server;
+    Session session;
+    session.send(REQUEST(URL(server.url())));
+    const auto recorded = session.get_latency_stats().snapshot();
+    assert(recorded.size() == 1 && recorded[0].first.status == "2xx" && recorded[0].second.count() == 1);
+    
+    std::cout << "✓ Latency histograms test passed" << std::endl;
+}
+
+void test_session_statistics() {
+    std::cout << "Testing session statistics..." << std::endl;
+    using namespace std::chrono;
+    
+    // Threads add to their own shards; a read sums them
+    SessionCounters counters;
+    {
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < 8; ++t) {
+            threads.emplace_back([&counters] {
+                for (int i = 0; i < 1000; ++i) {
+                    counters.record(i % 100 ? CURLE_OK : CURLE_OPERATION_TIMEDOUT, 10, 100, microseconds(50));
+                }
+            });
+        }
+    }
+    [[maybe_unused]] const STATISTICS totals = counters.read();
+    assert(totals.requests == 8000 && counters.requests() == 8000);
+    assert(totals.failures == 80 && totals.errors_for(CURLE_OPERATION_TIMEDOUT) == 80);
+    assert(totals.bytes_sent == 80000 && totals.bytes_received == 800000);
+    assert(totals.total_time == microseconds(400000) && totals.average_response_time() == 0.00005);
+    
+    ReplyServer server;
+    Session session;
+    session.send(REQUEST(URL(server.url())));
+    [[maybe_unused]] const auto refused = session.try_send(REQUEST(URL("http://127.0.0.1:1/")));
+    [[maybe_unused]] const STATISTICS stats = session.get_statistics();
+    assert(stats.requests == 2 && stats.failures == 1 && stats.errors_for(CURLE_COULDNT_CONNECT) == 1);
+    assert(stats.bytes_received == 40); // Status line, header, blank line and "ok"
+    assert(stats.bytes_sent > 0 && stats.total_time.count() > 0);
+    
+    std::cout << "✓ Session statistics test passed" << std::endl;
+}
+
+void test_traffic_accounting() {
+    std::cout << "Testing traffic accounting..." << std::endl;
+    
+    TRAFFIC gzip;
+    gzip.request_headers = 100;
+    gzip.response_headers = 200;
+    gzip.wire_body = 1000;
+    gzip.decoded_body = 8000;
+    assert(gzip.sent() == 100 && gzip.received() == 1200 && gzip.wire() == 1300);
+    assert(gzip.compression_ratio() == 8.0 && TRAFFIC().compression_ratio() == 1.0);
+    
+    ReplyServer server;
+    Session session;
+    const RESPONSE get = session.send(REQUEST(URL(server.url())));
+    [[maybe_unused]] const TRAFFIC& received = get.traffic;
+    assert(received.response_headers == 38 && received.wire_body == 2 && received.decoded_body == 2);
+    assert(received.request_body == 0 && received.request_headers > 0);
+    assert(ResponseUtils::calculate_response_efficiency(get) == 2.0 / static_cast<double>(received.wire()));
+    
+    const RESPONSE post = session.send(REQUEST(URL(server.url())).method("POST").body(BODY("hello")));
+    assert(post.traffic.request_body == 5 && post.traffic.request_headers > received.request_headers);
+    
+    [[maybe_unused]] const auto hosts = session.get_traffic_stats().snapshot();
+    assert(hosts.size() == 1 && hosts[0].host == "http://127.0.0.1:" + std::to_string(server.port));
+    assert(hosts[0].requests == 2 && hosts[0].traffic.request_body == 5 && hosts[0].traffic.decoded_body == 4);
+    assert(session.get_statistics().bytes_sent == hosts[0].traffic.sent());
+    
+    TrafficStats capped(1);
+    capped.record("http://a:80", gzip);
+    capped.record("http://b:80", gzip);
+    capped.record("http://c:80", gzip);
+    [[maybe_unused]] const auto folded = capped.snapshot();
+    assert(folded.size() == 2 && folded[0].host == "http://a:80");
+    assert(folded[1].host == HostLimit::OTHER_HOST && folded[1].requests == 2);
+    
+    std::cout << "✓ Traffic accounting test passed" << std::endl;
+}
+
+void test_connection_stats() {
+    std::cout << "Testing connection telemetry..." << std::endl;
+    
+    ReplyServer server; // Serves one connection at a time
+    Session session;
+    session.set_max_connections_per_host(1);
+    {
+        // The limit queues concurrent requests on the one connection instead of opening more
+        AsyncSession async(session);
+        std::vector<std::future<RESPONSE>> responses;
+        for (int i = 0; i < 4; ++i) {
+            responses.push_back(async.send(REQUEST(URL(server.url())).timeout(TIMEOUT(std::chrono::seconds(5)))));
+        }
+        for (auto& response : responses) {
+            [[maybe_unused]] const RESPONSE done = response.get();
+            assert(done.statusCode == 200);
+        }
+    } // Closes the loop's connection
+    session.send(REQUEST(URL(server.url())));
+    
+    [[maybe_unused]] const auto hosts = session.get_connection_stats().snapshot();
+    assert(hosts.size() == 1 && hosts[0].host == "http://127.0.0.1:" + std::to_string(server.port));
+    assert(hosts[0].opened == 2 && hosts[0].closed == 1 && hosts[0].open() == 1); // Session and loop each opened one
+    assert(hosts[0].requests == 5 && hosts[0].reused == 3 && hosts[0].requests_per_connection() == 2.5);
+    assert(hosts[0].lifetime.count() > 0 && hosts[0].longest == hosts[0].lifetime);
+    
+    std::cout << "✓ Connection telemetry test passed" << std::endl;
+}
+
+void test_request_ids() {
+    std::cout << "Testing request ids..." << std::endl;
+    
+    // Unique across threads without a shared counter
+    std::vector<uint64_t> ids(4 * 1000);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&ids, t] {
+            for (size_t i = 0; i < 1000; ++i) {
+                ids[t * 1000 + i] = next_request_id();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    std::sort(ids.begin(), ids.end());
+    assert(std::adjacent_find(ids.begin(), ids.end()) == ids.end());
+    assert(std::find(ids.begin(), ids.end(), 0) == ids.end());
+    
+    std::cout << "✓ Request id test passed" << std::endl;
+}
+
+void test_debug_capture() {
+    std::cout << "Testing tail-sampled debug capture..." << std::endl;
+    
+    // The ring keeps the newest events, oldest first
+    DEBUG_CAPTURE options;
+    options.max_events = 3;
+    options.max_event_bytes = 8;
+    DebugRecorder recorder(std::make_shared<const DEBUG_CAPTURE>(options), std::pmr::get_default_resource());
+    for (const char* text : {"one\n", "two\n", "three\n", "four\n", "a long header line\r\n"}) {
+        recorder.record(CURLINFO_TEXT, text);
+    }
+    assert(recorder.size() == 3);
+    assert(!recorder.finish("GET", "http://example.com/", CURLE_OK, 200, std::chrono::milliseconds(5)));
+    [[maybe_unused]] const auto kept = recorder.finish("GET", "http://example.com/", CURLE_OK, 503, std::chrono::milliseconds(5)).trace;
+    assert(kept && kept->dropped == 2 && kept->events.size() == 3);
+    assert(kept->events[0].text == "three" && kept->events[1].text == "four");
+    assert(kept->events[2].text == "a long h" && kept->events[2].truncated);
+    
+    // Credentials are redacted before they are stored, unless opted out
+    DEBUG_CAPTURE secrets;
+    secrets.slower_than = std::chrono::microseconds(0);
+    for (const bool redact : {true, false}) {
+        secrets.redact_secrets = redact;
+        DebugRecorder sent(std::make_shared<const DEBUG_CAPTURE>(secrets), std::pmr::get_default_resource());
+        sent.record(CURLINFO_HEADER_OUT, "GET /items?token=abc HTTP/1.1\r\nHost: example.com\r\n"
+                                         "Authorization: Bearer xyz\r\ncookie: sid=42\r\n\r\n");
+        sent.record(CURLINFO_HEADER_IN, "Set-Cookie: sid=43; HttpOnly\r\n");
+        sent.record(CURLINFO_TEXT, "Issue another request to this URL: 'https://bob:pw@example.com/next?key=v#top'\n");
+        [[maybe_unused]] const auto trace = sent.finish("GET", "https://bob:pw@example.com/items?token=abc", CURLE_OK, 200,
+                                                        std::chrono::milliseconds(1)).trace;
+        [[maybe_unused]] const std::string text = trace->to_string();
+        if (redact) {
+            assert(trace->url == "https://[redacted]@example.com/items?[redacted]");
+            assert(trace->events[0].text == "GET /items?[redacted] HTTP/1.1\r\nHost: example.com\r\n"
+                                            "Authorization: [redacted]\r\ncookie: [redacted]");
+            assert(trace->events[1].text == "Set-Cookie: [redacted]");
+            assert(text.find("'https://[redacted]@example.com/next?[redacted]#top'") != std::string::npos);
+            for ([[maybe_unused]] const char* secret : {"abc", "xyz", "sid=", "bob", "pw@", "key=v"}) {
+                assert(text.find(secret) == std::string::npos);
+            }
+        } else {
+            assert(trace->url == "https://bob:pw@example.com/items?token=abc");
+            assert(text.find("Authorization: Bearer xyz") != std::string::npos);
+        }
+    }
+    
+    ReplyServer server;
+    Session session;
+    std::vector<DebugTrace> flushed;
+    DEBUG_CAPTURE capture;
+    capture.slower_than = std::chrono::hours(1);
+    capture.sink = [&flushed](const DebugTrace& trace) { flushed.push_back(trace); };
+    session.set_debug_capture(capture);
+    
+    // Fast and successful: recorded, then dropped
+    [[maybe_unused]] const RESPONSE fast = session.send(REQUEST(URL(server.url())));
+    assert(fast.statusCode == 200 && !fast.debug_trace && flushed.empty());
+    
+    // Failed: flushed to the sink
+    [[maybe_unused]] const auto failed = session.try_send(REQUEST(URL("http://127.0.0.1:1/")));
+    assert(!failed && flushed.size() == 1 && flushed[0].result == failed.error().code);
+    assert(flushed[0].url == "http://127.0.0.1:1/" && !flushed[0].events.empty());
+    
+    // Slow (past a zero threshold): flushed and attached to the response
+    capture.slower_than = std::chrono::microseconds(0);
+    session.set_debug_capture(capture);
+    [[maybe_unused]] const RESPONSE slow = session.send(REQUEST(URL(server.url())));
+    assert(slow.debug_trace && flushed.size() == 2 && flushed[1].status == 200);
+    assert(std::any_of(slow.debug_trace->events.begin(), slow.debug_trace->events.end(),
+                       [](const DebugTrace::Event& event) { return event.type == CURLINFO_HEADER_OUT; }));
+    [[maybe_unused]] const std::string info = slow.get_debug_info();
+    assert(info.find("Status: 200") != std::string::npos && info.find("> GET / HTTP/1.1") != std::string::npos);
+    
+    // The sink runs after the session lock is released: waiting on another thread that uses the session is fine
+    capture.sink = [&session](const DebugTrace&) {
+        std::thread other([&session] { session.set_stall_detection(0, std::chrono::milliseconds(0)); });
+        other.join(); // Would never return if the sink ran under the lock
+    };
+    session.set_debug_capture(capture);
+    [[maybe_unused]] const RESPONSE unlocked = session.send(REQUEST(URL(server.url())));
+    assert(unlocked.debug_trace);
+    
+    capture.sink = [&flushed](const DebugTrace& trace) { flushed.push_back(trace); };
+    session.set_debug_capture(std::nullopt);
+    flushed.clear();
+    [[maybe_unused]] const RESPONSE off = session.send(REQUEST(URL(server.url())));
+    assert(!off.debug_trace && flushed.empty());
+    
+    std::cout << "✓ Debug capture test passed" << std::endl;
+}
+
+void test_cpu_accounting() {
+    std::cout << "Testing CPU time accounting..." << std::endl;
+    
+    ReplyServer server;
+    Session session;
+    [[maybe_unused]] const RESPONSE off = session.send(REQUEST(URL(server.url())));
+    assert(off.cpu_time == CPU_TIME{} && session.get_statistics().cpu_time == CPU_TIME{});
+    
+    session.set_cpu_accounting(true);
+    [[maybe_unused]] const RESPONSE on = session.send(REQUEST(URL(server.url())));
+    assert(on.statusCode == 200);
+    assert(on.cpu_time.setup.count() > 0 && on.cpu_time.callbacks.count() > 0);
+    assert(on.cpu_time.post.count() > 0 && on.cpu_time.libcurl.count() > 0);
+    assert(on.cpu_time.total() == on.cpu_time.library() + on.cpu_time.libcurl);
+    assert(session.get_statistics().cpu_time == on.cpu_time);
+    
+    // The loop thread's libcurl work is shared by all its transfers, so it is left out
+    ReplyServer async_server; // The session's connection holds the first one
+    CPU_TIME async_cpu;
+    {
+        AsyncSession async(session);
+        const RESPONSE response = async.send(REQUEST(URL(async_server.url()))).get();
+        async_cpu = response.cpu_time;
+    }
+    assert(async_cpu.setup.count() > 0 && async_cpu.callbacks.count() > 0 && async_cpu.libcurl.count() == 0);
+    assert(session.get_statistics().cpu_time.setup == on.cpu_time.setup + async_cpu.setup);
+    
+    std::cout << "✓ CPU time accounting test passed" << std::endl;
+}
+
+void test_response_shared_body() {
+    std::cout << "Testing shared response body..." << std::endl;
+    
+    RESPONSE response;
+    response.body = ResponseBody(std::string(1024 * 1024, 'x'));
+    
+    // Copies share the buffer instead of duplicating it
+    RESPONSE copy = response;
+    assert(copy.body.shares_buffer_with(response.body));
+    assert(copy.text_view().data() == response.text_view().data());
+    assert(copy.body.size() == 1024 * 1024);
+    
+    // Assignment replaces the buffer without touching other copies
+    copy.body = "replaced";
+    assert(copy.body == "replaced");
+    assert(response.body.size() == 1024 * 1024);
+    
+    std::cout << "✓ Shared response body test passed" << std::endl;
+}
+
+void test_response_segmented_body() {
+    std::cout << "Testing segmented response body..." << std::endl;
+    
+    // Spans more than one pooled block
+    const std::string payload = "{\"data\":\"" + std::string(BodyBlockPool::BLOCK_SIZE * 2, 'y') + "\"}";
+    
+    SegmentedBuffer segments;
+    for (size_t offset = 0; offset < payload.size(); offset += 1000) {
+        segments.append(payload.data() + offset, std::min<size_t>(1000, payload.size() - offset));
+    }
+    assert(segments.size() == payload.size());
+    assert(segments.block_count() == 3);
+    
+    RESPONSE response;
+    response.body = ResponseBody(std::move(segments));
+    assert(response.body.is_segmented());
+    assert(response.body.size() == payload.size());
+    
+    // Span iteration does not flatten
+    size_t total = 0;
+    for (const auto& span : response.body.spans()) {
+        total += span.size();
+    }
+    assert(total == payload.size());
+    
+    // Contiguous access flattens on demand and returns the blocks to the pool
+    [[maybe_unused]] const size_t cached = BodyBlockPool::instance().cached_blocks();
+    std::ostringstream streamed;
+    streamed << response.body;
+    assert(streamed.str() == payload);
+    assert(response.text_view() == payload);
+    assert(!response.body.is_segmented());
+    assert(BodyBlockPool::instance().cached_blocks() == cached + 3);
+    assert(response.body.str() == payload);
+    assert(response.json()["data"].get<std::string>().size() == BodyBlockPool::BLOCK_SIZE * 2);
+    
+    std::cout << "✓ Segmented response body test passed" << std::endl;
+}
+
+void test_response_spilled_body() {
+    std::cout << "Testing spilled response body..." << std::endl;
+    
+    LIMITS defaults;
+    assert(defaults.max_body_size == LIMITS::DEFAULT_MAX_BODY_SIZE);
+    assert(!defaults.spills());
+    
+    LIMITS spill = LIMITS::spill_after(1024);
+    assert(!spill.has_body_limit());
+    assert(spill.spills());
+    
+    SpillFile file;
+    const std::string chunk(4096, 'z');
+    for (int i = 0; i < 8; ++i) {
+        file.write(chunk.data(), chunk.size());
+    }
+    assert(file.size() == chunk.size() * 8);
+    
+    ResponseBody body(file.map());
+    assert(body.is_mapped());
+    assert(body.size() == chunk.size() * 8);
+    assert(body.view().substr(0, chunk.size()) == chunk);
+    
+    Session session;
+    session.set_limits(spill);
+    assert(session.get_limits().spill_threshold == 1024);
+    
+    std::cout << "✓ Spilled response body test passed" << std::endl;
+}
+
+void test_memory_budget() {
+    std::cout << "Testing memory budget..." << std::endl;
+    
+    auto budget = std::make_shared<MemoryBudget>(1024);
+    assert(budget->try_reserve(1000));
+    assert(!budget->try_reserve(100));
+    budget->release(1000);
+    assert(budget->used() == 0);
+    assert(budget->peak() == 1000);
+    
+    // A body keeps its charge until the last copy goes away
+    {
+        BudgetLease lease(budget);
+        assert(lease.try_grow(512));
+        ResponseBody body(std::string(512, 'b'));
+        body.hold(std::move(lease));
+        ResponseBody copy = body;
+        assert(budget->used() == 512);
+    }
+    assert(budget->used() == 0);
+    assert(budget->wait_for_capacity(std::chrono::milliseconds(1)));
+    
+    // Delayed requests give up at their deadline or when cancelled, instead of waiting forever
+    {
+        auto full = std::make_shared<MemoryBudget>(1024, MemoryBudget::Overflow::Delay);
+        full->reserve(1024);
+        Session session;
+        session.set_memory_budget(full);
+        [[maybe_unused]] const auto timed_out =
+            session.try_send(REQUEST(URL("http://127.0.0.1:1/")).timeout(TIMEOUT(std::chrono::milliseconds(20))));
+        assert(!timed_out && timed_out.error().code == CURLE_OPERATION_TIMEDOUT);
+        assert(timed_out.error().phase == Error::Phase::Setup);
+        
+        std::stop_source source;
+        std::thread canceller([&source] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            source.request_stop();
+        });
+        [[maybe_unused]] const auto cancelled = session.try_send(REQUEST(URL("http://127.0.0.1:1/")).cancel_on(source.get_token()));
+        canceller.join();
+        assert(!cancelled && cancelled.error().code == CURLE_ABORTED_BY_CALLBACK);
+        assert(full->delayed_requests() == 2);
+        full->release(1024);
+    }
+    
+    // Sessions register with the shared budget
+    {
+        Session session;
+        session.set_memory_budget(budget);
+        assert(budget->registered_sessions() == 1);
+    }
+    assert(budget->registered_sessions() == 0);
+    
+    RESPONSE response;
+    response.body = ResponseBody(std::string(4096, 'r'));
+    assert(response.estimate_memory_usage() >= 4096);
+    assert(ResponseUtils::estimate_memory_footprint(response) == response.estimate_memory_usage());
+    
+    std::cout << "✓ Memory budget test passed" << std::endl;
+}
+
+void test_request_arena() {
+    std::cout << "Testing request arena..." << std::endl;
+    
+    HEADERS copied;
+    {
+        RequestArena::Scope outer;
+        {
+            RequestArena::Scope inner;
+            assert(RequestArena::depth() == 2);
+        }
+        assert(RequestArena::depth() == 1);
+        
+        HEADERS headers(outer.resource());
+        headers.add("Accept", "application/json");
+        assert(headers.resource() == outer.resource());
+        
+        // Copies go back to the default resource and outlive the scope
+        copied = headers;
+        HEADERS rebound(headers, std::pmr::get_default_resource());
+        assert(rebound.resource() == std::pmr::get_default_resource());
+        
+        COOKIES cookies(outer.resource());
+        cookies.add("session", "abc");
+        assert(cookies.get("session") == "abc");
+        
+        PARAMS params(outer.resource());
+        params.add("page", "1");
+        assert(params.get().size() == 1);
+        
+        RESPONSE response(outer.resource());
+        assert(response.headers.resource() == outer.resource());
+    }
+    assert(RequestArena::depth() == 0);
+    assert(copied.resource() == std::pmr::get_default_resource());
+    assert(copied.get("Accept") == "application/json");
+    
+    std::cout << "✓ Request arena test passed" << std::endl;
+}
+
+void test_query_encoding() {
+    std::cout << "Testing query encoding..." << std::endl;
+    
+    assert(PercentEncoder::encode("a-z_0.9~") == "a-z_0.9~");
+    assert(PercentEncoder::encode("a b&c=d/\xff") == "a%20b%26c%3Dd%2F%FF");
+    assert(PercentEncoder::encode("a b*~", EncodeMode::Form) == "a+b*%7E");
+    assert(PercentEncoder::encoded_size("a b&") == 8);
+    
+    PARAMS params{{"q", "hello world"}, {"tags", "a,b"}, {"empty", ""}};
+    const std::string query = QueryBuilder::build(params);
+    assert(query == "q=hello%20world&tags=a%2Cb&empty=");
+    assert(query.size() == QueryBuilder::encoded_size(params));
+    
+    BODY form = BODY::form(params);
+    assert(form.toString() == "q=hello+world&tags=a%2Cb&empty=");
+    
+    std::cout << "✓ Query encoding test passed" << std::endl;
+}
+
 void test_url_basic() {
     std::cout << "Testing basic URL functionality..." << std::endl;
     
@@ -97,14 +1360,101 @@ void test_url_basic() {
     std::cout << "✓ Basic URL test passed" << std::endl;
 }
 
+void test_parsed_url() {
+    std::cout << "Testing parsed URL..." << std::endl;
+    
+    ParsedURL parsed("HTTPS://Example.COM:8443/a/b?x=1&y=2#top");
+    assert(parsed.scheme() == "https");
+    assert(parsed.path() == "/a/b");
+    assert(parsed.query() == "x=1&y=2");
+    assert(parsed.fragment() == "top");
+    assert(parsed.port() == 8443 && parsed.has_explicit_port());
+    assert(parsed.host_key() == "https://example.com:8443");
+    assert(parsed.handle() != nullptr);
+    
+    // Default port and guessed scheme land in the same host key
+    ParsedURL guessed("example.com/path");
+    assert(guessed.scheme() == "http");
+    assert(guessed.port() == 80 && !guessed.has_explicit_port());
+    assert(guessed.same_host(ParsedURL("http://EXAMPLE.com:80/other")));
+    
+    ParsedURL copy = parsed;
+    assert(copy.url() == parsed.url() && copy.handle() != parsed.handle());
+    
+    // URL parses once and shares the result with its copies
+    URL url("https://example.com/items");
+    const auto first = url.parsed();
+    URL url_copy = url;
+    assert(url.parsed() == first);
+    assert(url_copy.parsed() == first);
+    
+    [[maybe_unused]] bool rejected = false;
+    try {
+        ParsedURL invalid("http://[::1");
+    } catch (const RequestException&) {
+        rejected = true;
+    }
+    assert(rejected);
+    
+    std::cout << "✓ Parsed URL test passed" << std::endl;
+}
+
+void test_url_template() {
+    std::cout << "Testing URL templates..." << std::endl;
+    
+    using ItemUrl = URL_TEMPLATE<"https://api.example.com/{tenant}/items/{id}">;
+    static_assert(ItemUrl::slot_count() == 2);
+    static_assert(ItemUrl::slot_name(0) == "tenant");
+    static_assert(ItemUrl::slot_name(1) == "id");
+    
+    assert(ItemUrl::expand_string("acme", 42) == "https://api.example.com/acme/items/42");
+    assert(ItemUrl::expand_string("a b/c", "x&y") == "https://api.example.com/a%20b%2Fc/items/x%26y");
+    assert(ItemUrl::expand(std::string("t"), -7).toString() == "https://api.example.com/t/items/-7");
+    
+    using Static = URL_TEMPLATE<"https://api.example.com/health">;
+    static_assert(Static::slot_count() == 0);
+    assert(Static::expand().toString() == "https://api.example.com/health");
+    
+    std::pmr::string out("prefix:");
+    URL_TEMPLATE<"{a}-{b}">::append(out, 1.5, "z");
+    assert(out == "prefix:1.5-z");
+    
+    // A '+' in an exponent must not reach the URL raw, where it decodes as a space
+    assert(ItemUrl::expand_string("t", 1e20) == "https://api.example.com/t/items/1e%2B20");
+    
+    std::cout << "✓ URL template test passed" << std::endl;
+}
+
 void test_method_basic() {
     std::cout << "Testing basic method functionality..." << std::endl;
     
     METHOD get_method = METHOD::GET;
     METHOD post_method = METHOD::POST;
     
-    assert(get_method.value == "GET");
-    assert(post_method.value == "POST");
+    assert(get_method.name() == "GET");
+    assert(post_method.name() == "POST");
+    assert(get_method.verb() == METHOD::Verb::GET);
+    assert(!post_method.is_custom());
+    
+    // Known names map to the enum; anything else is a custom method
+    METHOD parsed("DELETE");
+    assert(parsed == METHOD::DELETE);
+    assert(std::string_view(parsed.c_str()) == "DELETE");
+    
+    METHOD custom = "PURGE";
+    assert(custom.is_custom());
+    assert(custom.name() == "PURGE");
+    assert(METHOD("get").is_custom()); // Method names are case-sensitive
+    assert(!(custom == METHOD("LINK")));
+    
+    custom = "HEAD";
+    assert(custom.verb() == METHOD::Verb::HEAD && custom == METHOD::HEAD);
+    
+    // Verb templates carry the method as a compile-time tag
+    static_assert(VERB<METHOD::Verb::PATCH>::name == "PATCH");
+    static_assert(METHOD::parse_verb("OPTIONS") == METHOD::Verb::OPTIONS);
+    REQUEST request(URL("http://example.com"), VERB<METHOD::Verb::PUT>{});
+    assert(request.get_method() == METHOD::PUT);
     
     std::cout << "✓ Basic method test passed" << std::endl;
 }
@@ -125,6 +1475,22 @@ void test_params_basic() {
     assert(params_data["key1"] == "value1");
     assert(params_data["key2"] == "value2");
     
+    // Insertion order, repeated keys and numeric values
+    PARAMS batch;
+    batch.reserve(4, 64);
+    batch.add("id", 1).add("id", 22).add("ratio", 0.5).add("name", "x y");
+    assert(batch.size() == 4);
+    assert(batch.count("id") == 2);
+    assert(batch.get_all("id") == std::vector<std::string_view>({"1", "22"}));
+    assert(batch.get("ratio") == "0.5");
+    assert(batch[3].key == "name" && batch[3].value == "x y");
+    assert(QueryBuilder::build(batch) == "id=1&id=22&ratio=0.5&name=x%20y");
+    
+    batch.set("id", "3");
+    assert(batch.count("id") == 1);
+    assert(QueryBuilder::build(batch) == "ratio=0.5&name=x%20y&id=3");
+    assert(batch.get().at("id") == "3");
+    
     std::cout << "✓ Basic parameters test passed" << std::endl;
 }
 
@@ -150,11 +1516,35 @@ int main() {
     std::cout << "================" << std::endl;
     
     try {
+        test_runtime_allocator();
         test_headers_basic();
         test_headers_validation();
         test_session_basic();
+        test_trusted_session();
+        test_pipeline();
+        test_try_send();
+        test_timeouts();
+        test_cancellation();
+        test_timer_wheel();
+        test_async_session();
         test_response_basic();
+        test_response_timings();
+        test_latency_stats();
+        test_session_statistics();
+        test_traffic_accounting();
+        test_connection_stats();
+        test_request_ids();
+        test_debug_capture();
+        test_cpu_accounting();
+        test_response_shared_body();
+        test_response_segmented_body();
+        test_response_spilled_body();
+        test_memory_budget();
+        test_request_arena();
+        test_query_encoding();
         test_url_basic();
+        test_parsed_url();
+        test_url_template();
         test_method_basic();
         test_params_basic();
         test_cookies_basic();
@@ -0,0 +1,15 @@
+#pragma once
+
+// Stand-in for systemtap's <sys/sdt.h>, used only by the curlx_usdt_check
+// target so the tracepoint code compiles on machines without
+// systemtap-sdt-dev. Probes expand to nothing but still reference their
+// semaphore and arguments, like the real macros do.
+#ifndef _SDT_HAS_SEMAPHORES
+#error "Probes.hpp defines _SDT_HAS_SEMAPHORES before including <sys/sdt.h>"
+#endif
+
+template<typename... Args>
+inline void curlx_sdt_stub_use(const Args&...) noexcept {}
+
+#define STAP_PROBEV(provider, name, ...) \
+    ((void)provider##_##name##_semaphore, curlx_sdt_stub_use(__VA_ARGS__))